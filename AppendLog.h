@@ -0,0 +1,407 @@
+// ----------------------
+// prog/deque/AppendLog.h
+// Tj Wrenn
+// ----------------------
+
+#ifndef AppendLog_h
+#define AppendLog_h
+
+// --------
+// includes
+// --------
+
+#include <atomic> // atomic, memory_order
+#include <cassert> // assert
+#include <iterator> // random_access_iterator_tag
+#include <memory> // allocator
+
+// ----------
+// namespaces
+// ----------
+
+namespace dt{
+namespace prog{
+namespace deque{
+
+// ---------
+// AppendLog
+// ---------
+
+/**
+* An append-only log with Deque's outer array / block layout, written by one
+* thread and read by any number of threads without locks.
+*
+* The writer constructs the new element in its block and then publishes the
+* new size with release semantics.  A reader takes a View, which loads the
+* published size with acquire semantics and then the outer array, so every
+* element below the view's size (and the block holding it) is visible to it.
+* Blocks never move once published.  When the outer array fills up the writer
+* publishes a larger copy; the old one is kept until the log is destroyed so
+* readers still holding it can finish, which costs at most as much memory as
+* the current outer array.
+*/
+template < typename T, typename A = std::allocator<T> >
+class AppendLog{
+public:
+// --------
+// typedefs
+// --------
+
+typedef A allocator_type;
+typedef typename allocator_type::value_type value_type;
+
+typedef typename allocator_type::size_type size_type;
+typedef typename allocator_type::difference_type difference_type;
+
+typedef typename allocator_type::pointer pointer;
+typedef typename allocator_type::const_pointer const_pointer;
+
+typedef typename allocator_type::reference reference;
+typedef typename allocator_type::const_reference const_reference;
+
+private:
+// -------------
+// static consts
+// -------------
+
+/**
+* number of elements in a block, a power of two so readers index with a shift and a mask
+*/
+static const size_type block_size = 64;
+
+// ---
+// Map
+// ---
+
+/**
+* an outer array, and the outer array it replaced
+*/
+struct Map{
+	pointer* blocks;
+	size_type size;
+	Map* previous;};
+
+typedef typename A::template rebind<Map>::other map_allocator_type;
+typedef typename A::template rebind<pointer>::other outer_allocator_type;
+
+// ----
+// data
+// ----
+
+allocator_type a;
+
+/**
+* the current outer array
+*/
+std::atomic<Map*> map;
+
+/**
+* number of elements readers may access
+*/
+std::atomic<size_type> published;
+
+/**
+* number of elements, as seen by the writer
+*/
+size_type s;
+
+// -----
+// valid
+// -----
+
+/**
+* O(1)
+* M(1)
+* @return true if log is in valid state
+*/
+bool valid ()const {
+	const Map* m = map.load(std::memory_order_relaxed);
+	return (m != NULL && m->size * block_size >= s && published.load(std::memory_order_relaxed) == s);}
+
+/**
+* O(1)
+* M(n), where n is the number of blocks
+* @param n number of blocks the new outer array holds
+* @param previous the outer array it replaces
+* @return a new outer array with NULL blocks
+*/
+Map* createMap (size_type n, Map* previous){
+	map_allocator_type x(a);
+	outer_allocator_type y(a);
+	Map* m = x.allocate(1);
+	m->blocks = y.allocate(n);
+	m->size = n;
+	m->previous = previous;
+	for(size_type i = 0; i < n; ++i)
+		m->blocks[i] = NULL;
+	return m;}
+
+/**
+* publishes an outer array twice the size of the current one
+* O(n), where n is the number of blocks
+* M(n), where n is the number of blocks
+*/
+void grow (){
+	Map* old = map.load(std::memory_order_relaxed);
+	Map* m = createMap(old->size * 2, old);
+	for(size_type i = 0; i < old->size; ++i)
+		m->blocks[i] = old->blocks[i];
+	map.store(m, std::memory_order_release);}
+
+// -------
+// copying
+// -------
+
+AppendLog (const AppendLog&);
+AppendLog& operator = (const AppendLog&);
+
+public:
+// ----
+// View
+// ----
+
+/**
+* A reader's consistent snapshot of the log: the published size and an outer
+* array covering it.  Cheap to take and to copy; valid until the log is destroyed.
+*/
+class View{
+	friend class AppendLog;
+
+public:
+	// --------------
+	// const_iterator
+	// --------------
+
+	class const_iterator{
+		friend class View;
+
+	public:
+		typedef std::random_access_iterator_tag iterator_category;
+		typedef typename AppendLog::value_type value_type;
+		typedef typename AppendLog::difference_type difference_type;
+		typedef typename AppendLog::const_pointer pointer;
+		typedef typename AppendLog::const_reference reference;
+
+	private:
+		const View* theview;
+		difference_type cur;
+
+	public:
+		const_iterator ()
+			: theview(NULL), cur(0) {}
+
+		reference operator * ()const {
+			return (*theview)[cur];}
+
+		pointer operator -> ()const {
+			return &**this;}
+
+		reference operator [] (difference_type i)const {
+			return (*theview)[cur + i];}
+
+		const_iterator& operator ++ (){
+			++cur;
+			return *this;}
+
+		const_iterator operator ++ (int){
+			const_iterator x = *this;
+			++cur;
+			return x;}
+
+		const_iterator& operator -- (){
+			--cur;
+			return *this;}
+
+		const_iterator operator -- (int){
+			const_iterator x = *this;
+			--cur;
+			return x;}
+
+		const_iterator& operator += (difference_type v){
+			cur += v;
+			return *this;}
+
+		const_iterator& operator -= (difference_type v){
+			cur -= v;
+			return *this;}
+
+		const_iterator operator + (difference_type v)const {
+			const_iterator r = *this;
+			return r += v;}
+
+		const_iterator operator - (difference_type v)const {
+			const_iterator r = *this;
+			return r -= v;}
+
+		difference_type operator - (const const_iterator& that)const {
+			return cur - that.cur;}
+
+		bool operator == (const const_iterator& that)const {
+			return (cur == that.cur) && (theview == that.theview);}
+
+		bool operator != (const const_iterator& that)const {
+			return !(*this == that);}
+
+		bool operator < (const const_iterator& that)const {
+			return cur < that.cur;}
+
+		bool operator > (const const_iterator& that)const {
+			return that < *this;}
+
+		bool operator <= (const const_iterator& that)const {
+			return !(that < *this);}
+
+		bool operator >= (const const_iterator& that)const {
+			return !(*this < that);}};
+
+private:
+	const_pointer const* blocks;
+	size_type s;
+
+public:
+	/**
+	* O(1)
+	* M(1)
+	*/
+	View ()
+		: blocks(NULL), s(0) {}
+
+	/**
+	* O(1)
+	* M(1)
+	* @param index element index, less than size()
+	* @return constant reference to value at the index'th position
+	*/
+	const_reference operator [] (size_type index)const {
+		return blocks[index / block_size][index % block_size];}
+
+	/**
+	* O(1)
+	* M(1)
+	* @return number of elements visible through this view
+	*/
+	size_type size ()const {
+		return s;}
+
+	bool empty ()const {
+		return !s;}
+
+	const_iterator begin ()const {
+		const_iterator i;
+		i.theview = this;
+		i.cur = 0;
+		return i;}
+
+	const_iterator end ()const {
+		const_iterator i;
+		i.theview = this;
+		i.cur = s;
+		return i;}};
+
+// ---------
+// AppendLog
+// ---------
+
+/**
+* O(1)
+* M(1)
+* @param a allocator
+*/
+AppendLog (const allocator_type& a = allocator_type())
+	: a(a), map(NULL), published(0), s(0) {
+		map.store(createMap(1, NULL), std::memory_order_relaxed);
+		assert(valid());}
+
+/**
+* not safe to call while readers are still using views
+* O(n + outerSize)
+* M(1)
+*/
+~AppendLog (){
+	Map* m = map.load(std::memory_order_relaxed);
+	for(size_type i = 0; i < s; ++i)
+		a.destroy(&m->blocks[i / block_size][i % block_size]);
+	for(size_type i = 0; i < m->size && m->blocks[i] != NULL; ++i)
+		a.deallocate(m->blocks[i], block_size);
+	map_allocator_type x(a);
+	outer_allocator_type y(a);
+	while(m != NULL){
+		Map* p = m->previous;
+		y.deallocate(m->blocks, m->size);
+		x.deallocate(m, 1);
+		m = p;}}
+
+// ---------
+// push_back
+// ---------
+
+/**
+* appends v and publishes it to readers; writer thread only
+* ~O(1), unless the outer array must grow
+* M(1)
+* @param v value to append
+*/
+void push_back (const_reference v){
+	Map* m = map.load(std::memory_order_relaxed);
+	size_type b = s / block_size;
+	if(b == m->size){
+		grow();
+		m = map.load(std::memory_order_relaxed);}
+	if(m->blocks[b] == NULL)
+		m->blocks[b] = a.allocate(block_size);
+	a.construct(m->blocks[b] + (s % block_size), v);
+	++s;
+	published.store(s, std::memory_order_release);}
+
+// -----------
+// operator []
+// -----------
+
+/**
+* writer thread only; readers use a View
+* O(1)
+* M(1)
+* @param index element index
+* @return constant reference to value at the index'th position
+*/
+const_reference operator [] (size_type index)const {
+	const Map* m = map.load(std::memory_order_relaxed);
+	return m->blocks[index / block_size][index % block_size];}
+
+// ----
+// view
+// ----
+
+/**
+* safe to call from any thread
+* O(1)
+* M(1)
+* @return a snapshot of every element published so far
+*/
+View view ()const {
+	View v;
+	v.s = published.load(std::memory_order_acquire);
+	v.blocks = map.load(std::memory_order_acquire)->blocks;
+	return v;}
+
+// ----
+// size
+// ----
+
+/**
+* safe to call from any thread
+* O(1)
+* M(1)
+* @return number of elements published so far
+*/
+size_type size ()const {
+	return published.load(std::memory_order_acquire);}
+
+bool empty ()const {
+	return !size();}};
+
+} // deque
+} // prog
+} // dt
+
+#endif // AppendLog_h
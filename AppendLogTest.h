@@ -0,0 +1,90 @@
+// --------------------------
+// prog/deque/AppendLogTest.h
+// Tj Wrenn
+// --------------------------
+
+#ifndef AppendLogTest_h
+#define AppendLogTest_h
+
+// --------
+// includes
+// --------
+
+#include <atomic>  // atomic
+#include <cassert> // assert
+#include <thread>  // thread
+#include <vector>  // vector
+
+// ----------
+// namespaces
+// ----------
+
+namespace dt {
+namespace prog  {
+namespace deque  {
+
+// ---------------
+// append_log_test
+// ---------------
+
+/**
+ * function append_log_test is a tester of class AppendLog
+ */
+template <typename AppendLog>
+void append_log_test () {
+	typedef typename AppendLog::View View;
+
+	{
+	// push_back, [], views
+	AppendLog a;
+	assert(a.empty());
+	View v0 = a.view();
+	for(int i = 0; i < 1000; ++i)
+		a.push_back(i);
+	View v1 = a.view();
+	a.push_back(1000);
+
+	assert(a.size() == 1001);
+	assert(a[1000] == 1000);
+	assert(v0.empty());
+	assert(v1.size() == 1000);
+	assert(v1[999] == 999);
+	assert(&v1[0] == &a[0]); // blocks never move
+
+	int n = 0;
+	for(typename View::const_iterator i = v1.begin(); i != v1.end(); ++i)
+		n += (*i == i - v1.begin());
+	assert(n == 1000);
+	}
+
+	{
+	// one writer, several lock-free readers
+	const int count = 200000;
+	AppendLog a;
+	std::atomic<bool> failed(false);
+	std::vector<std::thread> readers;
+	for(int r = 0; r < 4; ++r)
+		readers.push_back(std::thread([&a, &failed, count] () {
+			View v;
+			do {
+				v = a.view();
+				for(int i = 0; i < (int)v.size(); i += 97)
+					if(v[i] != i)
+						failed = true;
+				if(!v.empty() && v[v.size() - 1] != (int)v.size() - 1)
+					failed = true;
+			} while((int)v.size() < count);}));
+	for(int i = 0; i < count; ++i)
+		a.push_back(i);
+	for(size_t r = 0; r < readers.size(); ++r)
+		readers[r].join();
+	assert(!failed);
+	assert(a.view().size() == (size_t)count);
+	}
+} // append_log_test
+
+} // deque
+} // prog
+} // dt
+
+#endif // AppendLogTest_h
@@ -0,0 +1,274 @@
+// -----------------------
+// prog/deque/BlockCache.h
+// Tj Wrenn
+// -----------------------
+
+#ifndef BlockCache_h
+#define BlockCache_h
+
+// --------
+// includes
+// --------
+
+#include <cstddef> // size_t, ptrdiff_t
+#include <new> // operator new, operator delete
+#include <utility> // forward
+#include <vector> // vector
+
+// ----------
+// namespaces
+// ----------
+
+namespace dt{
+namespace prog{
+namespace deque{
+
+// ----------
+// BlockCache
+// ----------
+
+/**
+* A free list of equally sized blocks, shared by the Deques of one owner
+* through CachedAllocator.  A block a Deque lets go of, when it is destroyed
+* or hands its storage back, waits here for the next Deque that needs one
+* instead of going back to the heap.
+*/
+class BlockCache{
+public:
+// --------
+// typedefs
+// --------
+
+typedef std::size_t size_type;
+
+/**
+* every block comes from operator new, so any allocator may free it
+*/
+static const bool heap_blocks = true;
+
+private:
+// ----
+// data
+// ----
+
+/**
+* size in bytes of the blocks kept, or 0 before the first one
+*/
+size_type bytes;
+
+/**
+* most blocks kept at once; the rest are freed
+*/
+size_type limit;
+
+std::vector<void*> blocks;
+
+// -------
+// copying
+// -------
+
+BlockCache (const BlockCache&);
+BlockCache& operator = (const BlockCache&);
+
+public:
+// ----------
+// BlockCache
+// ----------
+
+/**
+* O(1)
+* M(1)
+* @param limit most blocks to keep
+*/
+explicit BlockCache (size_type limit = 4096)
+	: bytes(0), limit(limit) {}
+
+/**
+* O(n)
+* M(1)
+*/
+~BlockCache (){
+	for(size_type i = 0; i < blocks.size(); ++i)
+		::operator delete(blocks[i]);}
+
+// ----
+// take
+// ----
+
+/**
+* O(1)
+* M(n)
+* @param n size in bytes
+* @return a cached block of n bytes, or a new one
+*/
+void* take (size_type n){
+	if(n == bytes && !blocks.empty()){
+		void* p = blocks.back();
+		blocks.pop_back();
+		return p;}
+	return ::operator new(n);}
+
+// ----
+// give
+// ----
+
+/**
+* O(1)
+* M(1)
+* @param p a block from take() or operator new
+* @param n its size in bytes
+*/
+void give (void* p, size_type n){
+	if(!bytes)
+		bytes = n;
+	if(n == bytes && blocks.size() < limit)
+		blocks.push_back(p);
+	else
+		::operator delete(p);}
+
+// ----
+// size
+// ----
+
+/**
+* O(1)
+* M(1)
+* @return number of blocks waiting to be reused
+*/
+size_type size ()const {
+	return blocks.size();}};
+
+// ---------------
+// CachedAllocator
+// ---------------
+
+/**
+* An allocator drawing from a Cache, or straight from the heap when it has
+* none.  Deque allocates its outer array through a default constructed,
+* rebound copy, so only its blocks come from the cache, which must outlive
+* the Deques drawing from it.
+*
+* A Cache is any class with BlockCache's take(), give() and heap_blocks, such
+* as SlabCache or HugePageArena.  It keeps blocks of the first size it is
+* given and passes every other size straight to operator new and operator
+* delete, and is not thread safe.  When heap_blocks is true, every block
+* comes from operator new, so any CachedAllocator can free it and all of
+* them compare equal.  When it is false, a block can only go back to the
+* cache it came from: only allocators drawing from the same cache compare
+* equal, and Deques that trade blocks (swap, append, split_at) must share one.
+*/
+template <typename T, typename Cache = BlockCache>
+class CachedAllocator{
+	template <typename U, typename C>
+	friend class CachedAllocator;
+
+public:
+// --------
+// typedefs
+// --------
+
+typedef T value_type;
+
+typedef std::size_t size_type;
+typedef std::ptrdiff_t difference_type;
+
+typedef T* pointer;
+typedef const T* const_pointer;
+
+typedef T& reference;
+typedef const T& const_reference;
+
+template <typename U>
+struct rebind{
+	typedef CachedAllocator<U, Cache> other;};
+
+private:
+// ----
+// data
+// ----
+
+Cache* cache;
+
+public:
+// ---------------
+// CachedAllocator
+// ---------------
+
+CachedAllocator ()
+	: cache(NULL) {}
+
+/**
+* @param cache cache to draw from, or NULL for the heap
+*/
+explicit CachedAllocator (Cache* cache)
+	: cache(cache) {}
+
+template <typename U>
+CachedAllocator (const CachedAllocator<U, Cache>& that)
+	: cache(that.cache) {}
+
+// --------
+// allocate
+// --------
+
+/**
+* O(1)
+* M(n)
+* @param n number of elements
+* @return uninitialized storage for n elements
+*/
+pointer allocate (size_type n){
+	return static_cast<pointer>(cache ? cache->take(n * sizeof(T)) : ::operator new(n * sizeof(T)));}
+
+// ----------
+// deallocate
+// ----------
+
+/**
+* O(1)
+* M(1)
+* @param p storage from allocate
+* @param n number of elements it was allocated for
+*/
+void deallocate (pointer p, size_type n){
+	if(cache)
+		cache->give(p, n * sizeof(T));
+	else
+		::operator delete(p);}
+
+// ------------------
+// construct, destroy
+// ------------------
+
+template <typename U, typename... Args>
+void construct (U* p, Args&&... args){
+	::new((void*)p) U(std::forward<Args>(args)...);}
+
+template <typename U>
+void destroy (U* p){
+	p->~U();}
+
+// --------
+// max_size
+// --------
+
+size_type max_size ()const {
+	return size_type(-1) / sizeof(T);}
+
+// -----------
+// operator ==
+// -----------
+
+template <typename U>
+bool operator == (const CachedAllocator<U, Cache>& that)const {
+	return Cache::heap_blocks || cache == that.cache;}
+
+template <typename U>
+bool operator != (const CachedAllocator<U, Cache>& that)const {
+	return !(*this == that);}};
+
+} // deque
+} // prog
+} // dt
+
+#endif // BlockCache_h
@@ -0,0 +1,772 @@
+// ---------------------
+// prog/deque/CowDeque.h
+// Tj Wrenn
+// ---------------------
+
+#ifndef CowDeque_h
+#define CowDeque_h
+
+// --------
+// includes
+// --------
+
+#include <atomic> // atomic
+#include <cassert> // assert
+#include <iterator> // random_access_iterator_tag
+#include <memory> // allocator
+#include <stdexcept> // out_of_range
+#include <type_traits> // enable_if, is_integral
+#include <utility> // swap
+
+// ----------
+// namespaces
+// ----------
+
+namespace dt{
+namespace prog{
+namespace deque{
+
+// --------
+// CowDeque
+// --------
+
+/**
+* A deque with the same outer array / block layout as Deque, whose blocks are
+* reference counted and shared between copies.  Copying a CowDeque is
+* O(outerSize): the outer array is copied and every block that holds live
+* elements gains a reference.  A block is cloned the first time a write
+* (non-const access, push or assignment through a reference) touches it while
+* it is still shared.
+*
+* Reads should go through a const CowDeque (or the const overloads), since
+* non-const operator[] must assume the caller is about to write.
+*
+* A single CowDeque object is not thread safe, but copies of it may be handed
+* to other threads: the block reference counts are atomic.
+*/
+template < typename T, typename A = std::allocator<T> >
+class CowDeque{
+public:
+// --------
+// typedefs
+// --------
+
+typedef A allocator_type;
+typedef typename allocator_type::value_type value_type;
+
+typedef typename allocator_type::size_type size_type;
+typedef typename allocator_type::difference_type difference_type;
+
+typedef typename allocator_type::pointer pointer;
+typedef typename allocator_type::const_pointer const_pointer;
+
+typedef typename allocator_type::reference reference;
+typedef typename allocator_type::const_reference const_reference;
+
+private:
+// -------------
+// static consts
+// -------------
+
+/**
+* number of elements in a block.  larger than Deque's, since every block
+* carries a reference count and a constructed range.
+*/
+static const size_type block_size = 64;
+
+// -----
+// Block
+// -----
+
+/**
+* a shareable block.  [lo, hi) is the range of slots holding constructed
+* objects; it is only modified by a sole owner and is destroyed by whichever
+* owner drops the last reference.
+*/
+struct Block{
+	std::atomic<size_type> refs;
+	size_type lo;
+	size_type hi;
+	pointer data;};
+
+typedef typename A::template rebind<Block>::other block_allocator_type;
+typedef typename A::template rebind<Block*>::other outer_allocator_type;
+
+// ----
+// data
+// ----
+
+allocator_type a;
+
+/**
+* array of (possibly NULL) shared blocks
+*/
+Block** outer;
+
+/**
+* number of elements of the outer array
+*/
+size_type outerSize;
+
+/**
+* index of first element in CowDeque for internal purposes
+*/
+size_type f;
+
+/**
+* number of elements
+*/
+size_type s;
+
+// -----
+// valid
+// -----
+
+/**
+* O(1)
+* M(1)
+* @return true if deque is in valid state
+*/
+bool valid ()const {
+	return (outer != NULL && outerSize > 0 && f + s <= outerSize * block_size);}
+
+// ------
+// blocks
+// ------
+
+/**
+* O(1)
+* M(block_size)
+* @param o slot the new block's constructed range starts at
+* @return a new, unshared block with an empty constructed range
+*/
+Block* createBlock (size_type o){
+	block_allocator_type x(a);
+	Block* b = x.allocate(1);
+	b->data = a.allocate(block_size);
+	new (&b->refs) std::atomic<size_type>(1);
+	b->lo = b->hi = o;
+	return b;}
+
+/**
+* drops one reference to b, destroying its objects and freeing it if it was the last
+* O(block_size)
+* M(1)
+* @param b a block
+*/
+void releaseBlock (Block* b){
+	if(b->refs.fetch_sub(1, std::memory_order_acq_rel) != 1)
+		return;
+	for(size_type i = b->lo; i < b->hi; ++i)
+		a.destroy(b->data + i);
+	a.deallocate(b->data, block_size);
+	typedef std::atomic<size_type> counter;
+	b->refs.~counter();
+	block_allocator_type x(a);
+	x.deallocate(b, 1);}
+
+/**
+* O(1)
+* M(1)
+* @param b a block
+* @return true if this deque holds the only reference to b
+*/
+static bool unique (const Block* b){
+	return b->refs.load(std::memory_order_acquire) == 1;}
+
+/**
+* O(1)
+* M(1)
+* @param bi block index into outer
+* @param lo set to the first slot of bi holding one of this deque's elements
+* @param hi set to one past the last slot of bi holding one of this deque's elements
+*/
+void liveRange (size_type bi, size_type& lo, size_type& hi)const {
+	size_type first = bi * block_size;
+	size_type b = (f > first) ? f : first;
+	size_type e = (f + s < first + block_size) ? f + s : first + block_size;
+	if(b >= e){
+		lo = hi = 0;
+		return;}
+	lo = b - first;
+	hi = e - first;}
+
+/**
+* replaces the shared block bi by a private copy of this deque's elements in it
+* O(block_size)
+* M(block_size)
+* @param bi block index into outer
+* @return the private block
+*/
+Block* cloneBlock (size_type bi){
+	Block* old = outer[bi];
+	size_type lo, hi;
+	liveRange(bi, lo, hi);
+	Block* b = createBlock(lo);
+	for(; b->hi < hi; ++b->hi)
+		a.construct(b->data + b->hi, old->data[b->hi]);
+	outer[bi] = b;
+	releaseBlock(old);
+	return b;}
+
+/**
+* makes the block holding absolute index n private, allocating it if needed
+* O(block_size)
+* M(block_size)
+* @param n absolute index into the deque
+* @return the private block
+*/
+Block* ownBlock (size_type n){
+	size_type bi = n / block_size;
+	if(outer[bi] == NULL)
+		outer[bi] = createBlock(n % block_size);
+	else if(!unique(outer[bi]))
+		cloneBlock(bi);
+	return outer[bi];}
+
+/**
+* stores a copy of v at absolute index n, which is one past either end of the deque
+* O(block_size)
+* M(block_size)
+* @param n absolute index into the deque
+* @param v value to store
+*/
+void place (size_type n, const_reference v){
+	Block* b = ownBlock(n);
+	size_type o = n % block_size;
+	if(o >= b->lo && o < b->hi){ // slot still holds an object popped while shared
+		b->data[o] = v;
+		return;}
+	if(o + 1 < b->lo || o > b->hi){ // none of our elements are in b, forget its leftovers
+		for(size_type i = b->lo; i < b->hi; ++i)
+			a.destroy(b->data + i);
+		b->lo = b->hi = o;}
+	a.construct(b->data + o, v);
+	if(o == b->hi) ++b->hi;
+	else --b->lo;}
+
+/**
+* destroys the object at absolute index n if this deque owns it outright and
+* it is at an edge of its block's constructed range
+* O(1)
+* M(1)
+* @param n absolute index into the deque
+*/
+void unplace (size_type n){
+	Block* b = outer[n / block_size];
+	size_type o = n % block_size;
+	if(!unique(b))
+		return;
+	if(o + 1 == b->hi){
+		a.destroy(b->data + o);
+		--b->hi;}
+	else if(o == b->lo){
+		a.destroy(b->data + o);
+		++b->lo;}}
+
+/**
+* releases block bi once it no longer holds any of this deque's elements
+* O(1), O(block_size) if this was the last reference
+* M(1)
+* @param bi block index into outer
+*/
+void drop (size_type bi){
+	size_type lo, hi;
+	liveRange(bi, lo, hi);
+	if(lo != hi || outer[bi] == NULL)
+		return;
+	releaseBlock(outer[bi]);
+	outer[bi] = NULL;}
+
+// --------------
+// ensureCapacity
+// --------------
+
+/**
+* doubles the outer array, adding as many NULL blocks to the top as to the bottom
+* O(outerSize)
+* M(outerSize)
+*/
+void grow (){
+	size_type n = outerSize * 2 + 2;
+	size_type h = (n - outerSize) / 2;
+	outer_allocator_type x(a);
+	Block** newOuter = x.allocate(n);
+	for(size_type i = 0; i < n; ++i)
+		newOuter[i] = NULL;
+	for(size_type i = 0; i < outerSize; ++i)
+		newOuter[i + h] = outer[i];
+	x.deallocate(outer, outerSize);
+	outer = newOuter;
+	outerSize = n;
+	f += h * block_size;
+	assert(valid());}
+
+/**
+* allocation and initialization of an empty deque
+* O(1)
+* M(1)
+* @param n number of elements of the outer array
+*/
+void init (size_type n){
+	outer_allocator_type x(a);
+	outer = x.allocate(n);
+	for(size_type i = 0; i < n; ++i)
+		outer[i] = NULL;
+	outerSize = n;
+	f = (n * block_size) / 2;
+	s = 0;}
+
+/**
+* releases every block and the outer array
+* O(outerSize)
+* M(1)
+*/
+void release (){
+	for(size_type i = 0; i < outerSize; ++i)
+		if(outer[i] != NULL)
+			releaseBlock(outer[i]);
+	outer_allocator_type x(a);
+	x.deallocate(outer, outerSize);}
+
+/**
+* shares that's blocks, without touching this deque's current state
+* O(n), where n is that's outerSize
+* M(n), where n is that's outerSize
+* @param that a deque
+*/
+void share (const CowDeque& that){
+	init(that.outerSize);
+	f = that.f;
+	s = that.s;
+	for(size_type i = 0; i < outerSize; ++i){
+		size_type lo, hi;
+		that.liveRange(i, lo, hi);
+		if(lo == hi)
+			continue;
+		outer[i] = that.outer[i];
+		outer[i]->refs.fetch_add(1, std::memory_order_relaxed);}}
+
+public:
+// --------------
+// const_iterator
+// --------------
+
+class const_iterator{
+	friend class CowDeque;
+
+public:
+	// --------
+	// typedefs
+	// --------
+
+	typedef std::random_access_iterator_tag iterator_category;
+	typedef typename CowDeque::value_type value_type;
+	typedef typename CowDeque::difference_type difference_type;
+	typedef typename CowDeque::const_pointer pointer;
+	typedef typename CowDeque::const_reference reference;
+
+private:
+	// ----
+	// data
+	// ----
+
+	const CowDeque* thedeque;
+	difference_type cur;
+
+public:
+	/**
+	* O(1)
+	* M(1)
+	*/
+	const_iterator ()
+		: thedeque(NULL), cur(0) {}
+
+	/**
+	* O(1)
+	* M(1)
+	* @return value at current iterator position
+	*/
+	reference operator * ()const {
+		return (*thedeque)[cur];}
+
+	/**
+	* O(1)
+	* M(1)
+	* @return pointer to value at current iterator position
+	*/
+	pointer operator -> ()const {
+		return &**this;}
+
+	/**
+	* O(1)
+	* M(1)
+	* @param i offset from the current iterator position
+	* @return value at offset i
+	*/
+	reference operator [] (difference_type i)const {
+		return (*thedeque)[cur + i];}
+
+	const_iterator& operator ++ (){
+		++cur;
+		return *this;}
+
+	const_iterator operator ++ (int){
+		const_iterator x = *this;
+		++cur;
+		return x;}
+
+	const_iterator& operator -- (){
+		--cur;
+		return *this;}
+
+	const_iterator operator -- (int){
+		const_iterator x = *this;
+		--cur;
+		return x;}
+
+	const_iterator& operator += (difference_type v){
+		cur += v;
+		return *this;}
+
+	const_iterator& operator -= (difference_type v){
+		cur -= v;
+		return *this;}
+
+	const_iterator operator + (difference_type v)const {
+		const_iterator r = *this;
+		return r += v;}
+
+	const_iterator operator - (difference_type v)const {
+		const_iterator r = *this;
+		return r -= v;}
+
+	difference_type operator - (const const_iterator& that)const {
+		return cur - that.cur;}
+
+	bool operator == (const const_iterator& that)const {
+		return (cur == that.cur) && (thedeque == that.thedeque);}
+
+	bool operator != (const const_iterator& that)const {
+		return !(*this == that);}
+
+	bool operator < (const const_iterator& that)const {
+		return cur < that.cur;}
+
+	bool operator > (const const_iterator& that)const {
+		return that < *this;}
+
+	bool operator <= (const const_iterator& that)const {
+		return !(that < *this);}
+
+	bool operator >= (const const_iterator& that)const {
+		return !(*this < that);}};
+
+public:
+// --------
+// CowDeque
+// --------
+
+/**
+* O(1)
+* M(1)
+* @param a allocator
+*/
+CowDeque (const allocator_type& a = allocator_type())
+	: a(a) {
+		init(1);
+		assert(valid());}
+
+/**
+* O(n)
+* M(n)
+* @param n initial size of the deque
+* @param v value to fill the deque with
+* @param a allocator
+*/
+CowDeque (size_type n, const_reference v, const allocator_type& a = allocator_type())
+	: a(a) {
+		init(1);
+		for(size_type i = 0; i != n; ++i)
+			push_back(v);
+		assert(valid());}
+
+/**
+* not a candidate for integral II, so CowDeque(5, 3) fills rather than copies
+* O(n), where n is the distance between first and last
+* M(n), where n is the distance between first and last
+* @param first beginning of a range of values
+* @param last end of a range of values
+* @param a allocator
+*/
+template <typename II>
+CowDeque (II first, II last, const allocator_type& a = allocator_type(),
+		typename std::enable_if<!std::is_integral<II>::value>::type* = 0)
+	: a(a) {
+		init(1);
+		for(; first != last; ++first)
+			push_back(*first);
+		assert(valid());}
+
+/**
+* shares that's blocks with the new deque
+* O(n), where n is that's outerSize
+* M(n), where n is that's outerSize
+* @param that a deque
+*/
+CowDeque (const CowDeque& that)
+	: a(that.a) {
+		share(that);
+		assert(valid());}
+
+/**
+* O(outerSize)
+* M(1)
+*/
+~CowDeque (){
+	release();}
+
+/**
+* shares that's blocks, dropping this deque's references to its own
+* O(n), where n is the outerSize of this and that
+* M(n), where n is that's outerSize
+* @param that a deque
+* @return this deque
+*/
+CowDeque& operator = (const CowDeque& that){
+	if(this == &that)
+		return *this;
+	CowDeque x(that);
+	swap(x);
+	return *this;}
+
+// -----------
+// operator []
+// -----------
+
+/**
+* clones the element's block first if it is shared
+* O(1), O(block_size) if the block is cloned
+* M(1), M(block_size) if the block is cloned
+* @param index element index in deque
+* @return reference to value at the index'th position
+*/
+reference operator [] (size_type index){
+	size_type n = f + index;
+	return ownBlock(n)->data[n % block_size];}
+
+/**
+* O(1)
+* M(1)
+* @param index element index in deque
+* @return constant reference to value at the index'th position
+*/
+const_reference operator [] (size_type index)const {
+	size_type n = f + index;
+	return outer[n / block_size]->data[n % block_size];}
+
+// --
+// at
+// --
+
+/**
+* O(1), O(block_size) if the block is cloned
+* M(1), M(block_size) if the block is cloned
+* @param index element index
+* @throw std::out_of_range
+* @return reference to value at the index'th position
+*/
+reference at (size_type index){
+	if(index >= size())
+		throw std::out_of_range("deque [] access out of range");
+	return (*this)[index];}
+
+/**
+* O(1)
+* M(1)
+* @param index element index
+* @throw std::out_of_range
+* @return constant reference to value at the index'th position
+*/
+const_reference at (size_type index)const {
+	if(index >= size())
+		throw std::out_of_range("deque [] access out of range");
+	return (*this)[index];}
+
+// -----------
+// front, back
+// -----------
+
+reference front (){
+	return (*this)[0];}
+
+const_reference front ()const {
+	return (*this)[0];}
+
+reference back (){
+	return (*this)[size() - 1];}
+
+const_reference back ()const {
+	return (*this)[size() - 1];}
+
+// ----------
+// begin, end
+// ----------
+
+/**
+* O(1)
+* M(1)
+* @return a constant iterator for the beginning of the deque
+*/
+const_iterator begin ()const {
+	const_iterator i;
+	i.thedeque = this;
+	i.cur = 0;
+	return i;}
+
+/**
+* O(1)
+* M(1)
+* @return a constant iterator for the end (one past the last element) of the deque
+*/
+const_iterator end ()const {
+	const_iterator i;
+	i.thedeque = this;
+	i.cur = size();
+	return i;}
+
+// ----
+// push
+// ----
+
+/**
+* ~O(1), unless capacity must be increased or the last block is shared
+* M(1)
+* @param v value to insert at back
+*/
+void push_back (const_reference v){
+	if(f + s == outerSize * block_size) grow();
+	place(f + s, v);
+	++s;
+	assert(valid());}
+
+/**
+* ~O(1), unless capacity must be increased or the first block is shared
+* M(1)
+* @param v value to insert at front
+*/
+void push_front (const_reference v){
+	if(f == 0) grow();
+	place(f - 1, v);
+	--f;
+	++s;
+	assert(valid());}
+
+// ---
+// pop
+// ---
+
+/**
+* never clones: an element popped from a shared block is destroyed by its last owner
+* O(1)
+* M(1)
+*/
+void pop_back (){
+	assert(!empty());
+	unplace(f + s - 1);
+	--s;
+	drop((f + s) / block_size);
+	assert(valid());}
+
+/**
+* never clones: an element popped from a shared block is destroyed by its last owner
+* O(1)
+* M(1)
+*/
+void pop_front (){
+	assert(!empty());
+	unplace(f);
+	++f;
+	--s;
+	drop((f - 1) / block_size);
+	assert(valid());}
+
+// -----
+// clear
+// -----
+
+/**
+* drops every block reference
+* O(outerSize)
+* M(1)
+*/
+void clear (){
+	CowDeque x(a);
+	swap(x);}
+
+// -----
+// empty
+// -----
+
+bool empty ()const {
+	return !size();}
+
+// ----
+// size
+// ----
+
+size_type size ()const {
+	return s;}
+
+// -------------
+// shared_blocks
+// -------------
+
+/**
+* O(outerSize)
+* M(1)
+* @return number of this deque's blocks that are also referenced by another deque
+*/
+size_type shared_blocks ()const {
+	size_type n = 0;
+	for(size_type i = 0; i < outerSize; ++i)
+		if(outer[i] != NULL && !unique(outer[i]))
+			++n;
+	return n;}
+
+// ----
+// swap
+// ----
+
+/**
+* O(1)
+* M(1)
+* @param that a deque
+*/
+void swap (CowDeque& that){
+	std::swap(a, that.a);
+	std::swap(outer, that.outer);
+	std::swap(outerSize, that.outerSize);
+	std::swap(f, that.f);
+	std::swap(s, that.s);}};
+
+// ----
+// swap
+// ----
+
+template <typename T, typename A>
+	/**
+	* swaps the data of deque x and deque y
+	* O(1)
+	* M(1)
+	* @param x a deque
+	* @param y another deque
+	*/
+	void swap (CowDeque<T, A>& x, CowDeque<T, A>& y){
+		x.swap(y);}
+
+} // deque
+} // prog
+} // dt
+
+#endif // CowDeque_h
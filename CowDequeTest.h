@@ -0,0 +1,142 @@
+// -------------------------
+// prog/deque/CowDequeTest.h
+// Tj Wrenn
+// -------------------------
+
+#ifndef CowDequeTest_h
+#define CowDequeTest_h
+
+// --------
+// includes
+// --------
+
+#include <cassert>   // assert
+#include <stdexcept> // out_of_range
+#include <string>    // string
+
+// ----------
+// namespaces
+// ----------
+
+namespace dt {
+namespace prog  {
+namespace deque  {
+
+// --------------
+// cow_deque_test
+// --------------
+
+/**
+ * function cow_deque_test is a tester of class CowDeque
+ */
+template <typename CowDeque>
+void cow_deque_test () {
+	{
+	// push, pop, [], at
+	CowDeque a;
+	assert(a.empty());
+	for(int i = 0; i < 200; ++i)
+		a.push_back(i);
+	a.push_front(-1);
+	assert(a.size() == 201);
+	assert(a.front() == -1);
+	assert(a.back() == 199);
+	assert(a[100] == 99);
+	a.pop_front();
+	a.pop_back();
+	assert(a.size() == 199);
+	assert(a.front() == 0);
+	assert(a.back() == 198);
+
+	try {
+		a.at(199);
+		assert(false);
+	} catch (const std::out_of_range& e) {
+		assert(std::string(e.what()) == "deque [] access out of range");
+	}
+	}
+
+	{
+	// copies share blocks until written
+	CowDeque a;
+	for(int i = 0; i < 1000; ++i)
+		a.push_back(i);
+
+	CowDeque b(a);
+	const CowDeque& ca = a;
+	const CowDeque& cb = b;
+	assert(&ca[500] == &cb[500]);
+	assert(a.shared_blocks() > 0);
+
+	b[500] = -500;                 // clones only the block holding 500
+	assert(ca[500] == 500);
+	assert(cb[500] == -500);
+	assert(&ca[0] == &cb[0]);
+	assert(&ca[999] == &cb[999]);
+
+	b.push_back(1000);             // clones the shared last block
+	a.pop_front();                 // shared, so nothing is destroyed
+	assert(cb[0] == 0);
+	assert(ca[0] == 1);
+	assert(b.size() == 1001);
+	assert(a.size() == 999);
+	}
+
+	{
+	// assignment, snapshots outliving the original
+	CowDeque s;
+	{
+	CowDeque a;
+	for(int i = 0; i < 300; ++i)
+		a.push_front(i);
+	s = a;
+	a.clear();
+	assert(a.empty());
+	}
+	assert(s.size() == 300);
+	assert(s.front() == 299);
+	assert(s.back() == 0);
+	assert(s.shared_blocks() == 0);
+
+	int n = 0;
+	for(typename CowDeque::const_iterator i = s.begin(); i != s.end(); ++i)
+		n += (*i == 299 - (i - s.begin()));
+	assert(n == 300);
+	}
+
+	{
+	// draining a copy releases the blocks it no longer needs
+	CowDeque a;
+	for(int i = 0; i < 256; ++i)
+		a.push_back(i);
+	CowDeque b = a;
+	while(b.size() > 10)
+		b.pop_front();
+	const CowDeque& cb = b;
+	assert(cb.front() == 246);
+	assert(a.shared_blocks() >= 1);
+	assert(a.shared_blocks() <= 2); // 10 elements span at most two blocks
+	a.swap(b);
+	assert(a.size() == 10);
+	assert(b.size() == 256);
+	}
+
+	{
+	// (size, value) must not be taken for an iterator range
+	const CowDeque x(5, 3);
+	assert(x.size() == 5);
+	for(int i = 0; i != 5; ++i)
+		assert(x[i] == 3);
+	const CowDeque y(x.begin(), x.end());
+	assert(y.size() == 5);
+	assert(y.back() == 3);
+	const CowDeque z(0, 3);
+	assert(z.empty());
+	}
+} // cow_deque_test
+
+} // deque
+} // prog
+} // dt
+
+#endif // CowDequeTest_h
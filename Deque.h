@@ -10,12 +10,19 @@
 // includes
 // --------
 
-#include <algorithm> // equal, lexicographical_compare
-#include <iterator> // random_access_iterator_tag
-#include <memory> // allocator
+#include <algorithm> // min, move, move_backward, rotate, swap
+#include <iterator> // distance, iterator_traits, make_move_iterator, random_access_iterator_tag
+#include <memory> // allocator, uninitialized_copy, uninitialized_fill_n
 #include <stdexcept> // out_of_range
+#include <utility> // move
 #include <cassert> //assert
 #include <cmath> // ceil
+#include <cstring> // memcmp, memset
+#include <cstdint> // uint64_t
+#include <type_traits> // integral_constant, is_integral, is_enum, is_pointer, is_floating_point, is_trivially_copyable, is_trivially_destructible
+
+#include "DequeObserver.h"
+#include "DequeStats.h"
 
 using namespace std;
 
@@ -31,8 +38,13 @@ namespace deque{
 // Deque
 // -----
 
-template < typename T, typename A = std::allocator<T> >
-class Deque{
+/**
+* S is the statistics policy, NoStats unless given; see DequeStats.h.  O is the
+* observer policy, NoObserver unless given; see DequeObserver.h.  both are
+* private bases, so an empty policy takes no room.
+*/
+template < typename T, typename A = std::allocator<T>, typename S = NoStats, typename O = NoObserver >
+class Deque : private S, private O{
 public:
 // --------
 // typedefs
@@ -50,6 +62,9 @@ typedef typename allocator_type::const_pointer const_pointer;
 typedef typename allocator_type::reference reference;
 typedef typename allocator_type::const_reference const_reference;
 
+typedef S stats_type;
+typedef O observer_type;
+
 // -------
 // friends
 // -------
@@ -64,7 +79,7 @@ typedef typename allocator_type::const_reference const_reference;
 friend bool operator == (const Deque& lhs, const Deque& rhs){
 	return
 		(lhs.size() == rhs.size()) &&
-		std::equal(lhs.begin(), lhs.end(), rhs.begin());}
+		(mismatch(lhs, rhs, lhs.size(), false) == lhs.size());}
 
 /**
 * O(n)
@@ -84,7 +99,9 @@ friend bool operator != (const Deque& lhs, const Deque& rhs){
 * @return true if lhs is less than rhs
 */
 friend bool operator < (const Deque& lhs, const Deque& rhs){
-	return std::lexicographical_compare(lhs.begin(), lhs.end(), rhs.begin(), rhs.end());}
+	size_type n = (lhs.size() < rhs.size()) ? lhs.size() : rhs.size();
+	size_type i = mismatch(lhs, rhs, n, true);
+	return (i < n) ? (lhs[i] < rhs[i]) : (lhs.size() < rhs.size());}
 
 /**
 * O(n)
@@ -122,9 +139,16 @@ private:
 // -------------
 
 /**
-* Length of the outer array
+* Length of each block the outer array points to: 512 bytes' worth of T, so
+* a block is long enough to be worth handing to a vectorized loop
 */
-static const size_type block_size = 10;
+static const size_type block_size = (sizeof(T) < 256) ? 512 / sizeof(T) : 2;
+
+/**
+* Slots of the next outer array that a push fills while a migration is under
+* way; see migrate()
+*/
+static const size_type migrate_step = 8;
 
 private:
 // ----
@@ -163,6 +187,16 @@ pointer* outer;
 */
 size_type outerSize;
 
+/**
+* outer array being filled by migrate() while outer stays in use, or NULL.
+* slot i of outer goes to slot (i + nextShift) % nextSize of next, and slots
+* [0, filled) of next are already written.
+*/
+pointer* next;
+size_type nextSize;
+size_type nextShift;
+size_type filled;
+
 /**
 * index of first element in Deque for internal purposes
 */
@@ -187,7 +221,7 @@ bool valid ()const {
 	if( __instances < 0) return false;
 #endif
 
-	return (outer != NULL && outerSize > 0 && block_size > 0 && l >= 0 && f >= 0 && c >= s && c >= 0);}
+	return (outer != NULL && outerSize > 0 && block_size > 0 && l >= 0 && f >= 0 && c >= s && c >= 0 && (next == NULL || filled < nextSize));}
 
 public:
 // --------
@@ -976,14 +1010,21 @@ private:
 // ensureCapacity
 // --------------
 /**
-* ensures the requested capacity in the Deque
+* ensures the requested capacity in the Deque, finishing any migration first.
+* only the outer array is reallocated, all at once; the slots it gains are
+* left empty and get their blocks from slot() when an element is first put
+* there.  pushes grow through migrate() instead, and come here only when a
+* bulk operation has used up the room a migration needs.
 * O(n), where n is the capacity / block_size.
-* M(n), where n is the requested capacity
+* M(n / block_size), where n is the requested capacity
 * @param capacity the requested capacity to which to adjust the Deque
 */
 void ensureCapacity(size_type capacity){
+	settle();
 	if(c >= capacity)
 		return; //nothing to do
+	std::uint64_t t0 = observeStart();
+	size_type oldC = c;
 	size_type n = (c*2)+1;
 	if(capacity > n) n = capacity; //make sure new capacity is enough
 
@@ -992,6 +1033,7 @@ void ensureCapacity(size_type capacity){
 	if(n % 2) ++n; //make sure we add as many new arrays to bottom as we do to top
 	if(n == 2) ++n; //add at least one on bottom and one on top
 
+	S::grown(c, n * block_size);
 	c = n * block_size; //increase capacity
 
 	typename A::template rebind<pointer>::other x;
@@ -1006,7 +1048,7 @@ void ensureCapacity(size_type capacity){
 
 	//top
 	for(difference_type i = 0; i < h; ++i){
-		newOuter[i] = this->a.allocate(block_size);
+		newOuter[i] = NULL;
 	}
 
 	//middle
@@ -1016,13 +1058,14 @@ void ensureCapacity(size_type capacity){
 
 	//bottom
 	for(difference_type i = oldOuterSize + h; i < n; ++i){
-		newOuter[i] = this->a.allocate(block_size);
+		newOuter[i] = NULL;
 	}
 
 	x.deallocate(outer, oldOuterSize);
 	outer = newOuter;
 	outerSize = newOuterSize;
 
+	notify(DequeEvent::grow, oldC, c, outerSize, t0);
 	assert(valid());
 }
 
@@ -1040,6 +1083,44 @@ iterator middle (){
 	i.cur = size() / 2;
 	return i;}
 
+/**
+* walks both deques a segment at a time, cutting wherever either one crosses
+* into a new block, so each piece is contiguous on both sides.  for integral,
+* enum and pointer types, equal bytes mean equal values, so a piece whose bytes
+* match (checked with memcmp) is skipped without looking at its elements.  the
+* same holds for floating point types, except that a NaN is not equal to itself.
+* O(n)
+* M(1)
+* @param lhs a deque
+* @param rhs a deque
+* @param n number of leading elements to compare, at most the smaller size
+* @param ordered compare with < (as lexicographical_compare does) rather than ==
+* @return index of the first position in [0, n) where lhs and rhs differ, or n
+*/
+static size_type mismatch(const Deque& lhs, const Deque& rhs, size_type n, bool ordered){
+	const bool bitwise = std::is_integral<T>::value || std::is_enum<T>::value || std::is_pointer<T>::value;
+	const bool floating = std::is_floating_point<T>::value;
+	size_type i = 0;
+	while(i < n){
+		size_type k = lhs.segment_length(i);
+		if(rhs.segment_length(i) < k) k = rhs.segment_length(i);
+		if(n - i < k) k = n - i;
+		const_pointer p = &lhs[i];
+		const_pointer q = &rhs[i];
+		bool same = (bitwise || floating) && std::memcmp(p, q, k * sizeof(T)) == 0;
+		if(same && floating && !ordered){
+			size_type nans = 0;
+			for(size_type j = 0; j < k; ++j)
+				nans += (p[j] != p[j]);
+			same = !nans;}
+		if(!same){
+			for(size_type j = 0; j < k; ++j)
+				if(ordered ? (p[j] < q[j] || q[j] < p[j]) : !(p[j] == q[j]))
+					return i + j;}
+		i += k;}
+	return n;
+}
+
 /**
 * allocation and initialization of deque
 * O(1)
@@ -1048,12 +1129,16 @@ iterator middle (){
 void init(){
 	typename A::template rebind<pointer>::other x;
 	outer = x.allocate(1);
-	outer[0] = this->a.allocate(block_size);
 	f = (block_size) / 2;
 	l = f - 1;
 	c = block_size;
 	s = 0;
 	outerSize = 1;
+	outer[0] = allocateBlock();
+	next = NULL;
+	nextSize = 0;
+	nextShift = 0;
+	filled = 0;
 
 #ifndef NDEBUG
 	__instances = 0;
@@ -1080,6 +1165,510 @@ size_type bottomCapacity()const {
 	return c - size() - topCapacity();
 }
 
+/**
+* allocates the block of an empty slot of the outer array
+* O(1)
+* M(block_size)
+* @param n absolute index of a position that is about to hold an element
+* @return pointer to that position
+*/
+pointer slot(size_type n){
+	pointer& b = outer[n / block_size];
+	if(b == NULL){
+		b = allocateBlock();
+		mirror(n / block_size);}
+	return b + n % block_size;
+}
+
+/**
+* writes slot b of the outer array through to the next one, if migrate() has
+* already filled the slot it goes to
+* O(1)
+* M(1)
+* @param b index into the outer array
+*/
+void mirror(size_type b){
+	if(next != NULL && (b + nextShift) % nextSize < filled)
+		next[(b + nextShift) % nextSize] = outer[b];
+}
+
+/**
+* the room left at the end being pushed onto at which a push starts a
+* migration: a new outer array of at most 2 * outerSize + 2 slots, filled
+* migrate_step slots a push, is then full before that room runs out
+* O(1)
+* M(1)
+*/
+size_type migrateRoom()const {
+	return (2 * outerSize + 2 + migrate_step - 1) / migrate_step;
+}
+
+/**
+* moves the outer array a few slots per push, so that no push copies it in
+* full.  once the room at the end being pushed onto is down to migrateRoom(),
+* a new outer array is allocated: the same size, with the unused blocks to be
+* split evenly between the ends as recenter() does, if at most half of the
+* blocks hold elements; else the size ensureCapacity(c + 1) would pick.  each
+* push then fills migrate_step of its slots, and the push that fills the last
+* one switches to it.  until then every read goes to the old outer array, and
+* a write to a slot that is already copied is written through by mirror().
+* O(1)
+* M(outerSize) when a migration starts
+* @param room elements of room left at the end being pushed onto
+*/
+void migrate(size_type room){
+	if(next == NULL){
+		if(room > migrateRoom() || empty())
+			return;
+		size_type fb = f / block_size;
+		size_type used = (f + size() - 1) / block_size - fb + 1;
+		if(used * 2 <= outerSize){
+			nextSize = outerSize;
+			nextShift = ((outerSize - used) / 2 + outerSize - fb) % outerSize;}
+		else{
+			nextSize = 2 * outerSize + 2;
+			nextShift = (nextSize - outerSize) / 2;}
+		typename A::template rebind<pointer>::other x;
+		next = x.allocate(nextSize);
+		filled = 0;}
+	fillNext(migrate_step);
+}
+
+/**
+* fills up to k more slots of the next outer array, switching to it when it is full
+* O(k), plus O(outerSize) in the rare case the switch must rotate it
+* M(1)
+* @param k number of slots
+*/
+void fillNext(size_type k){
+	size_type e = (nextSize - filled < k) ? nextSize : filled + k;
+	for(; filled < e; ++filled){
+		size_type i = (filled + nextSize - nextShift) % nextSize; // the old slot that goes here
+		next[filled] = (i < outerSize) ? outer[i] : NULL;}
+	if(filled < nextSize)
+		return;
+
+	std::uint64_t t0 = observeStart();
+	size_type oldC = c;
+	size_type fb = (f / block_size + nextShift) % nextSize;
+	if(!empty()){
+		size_type lb = ((f + size() - 1) / block_size + nextShift) % nextSize;
+		if(lb < fb){ // pushes during a same-size migration carried the elements round the end
+			size_type t = (fb - lb - 1) / 2;
+			std::rotate(next, next + (fb - t), next + nextSize);
+			fb = t;}}
+	f = fb * block_size + f % block_size;
+	l = f + size() - 1;
+	typename A::template rebind<pointer>::other x;
+	x.deallocate(outer, outerSize);
+	bool grows = nextSize > outerSize;
+	outer = next;
+	outerSize = nextSize;
+	next = NULL;
+	c = outerSize * block_size;
+	if(grows){
+		S::grown(oldC, c);
+		notify(DequeEvent::grow, oldC, c, outerSize, t0);}
+	else
+		notify(DequeEvent::recenter, c, c, outerSize, t0);
+	assert(valid());
+}
+
+/**
+* finishes a migration at once, for the operations that rewrite the outer array
+* O(outerSize) if a migration is under way, else O(1)
+* M(1)
+*/
+void settle(){
+	if(next != NULL)
+		fillNext(nextSize);
+}
+
+/**
+* O(1)
+* M(block_size)
+* @return a new block
+*/
+pointer allocateBlock(){
+	S::block_allocated(block_size * sizeof(T));
+	std::uint64_t t0 = observeStart();
+	pointer p = this->a.allocate(block_size);
+	notify(DequeEvent::block_allocated, c, c, block_size * sizeof(T), t0);
+	return p;
+}
+
+/**
+* O(1)
+* M(1)
+* @param p a block from allocateBlock()
+*/
+void freeBlock(pointer p){
+	S::block_freed(block_size * sizeof(T));
+	std::uint64_t t0 = observeStart();
+	this->a.deallocate(p, block_size);
+	notify(DequeEvent::block_freed, c, c, block_size * sizeof(T), t0);
+}
+
+/**
+* O(1)
+* M(1)
+* @return the time to measure an event from, if the observer is enabled
+*/
+std::uint64_t observeStart()const {
+	return O::enabled ? deque_clock() : 0;
+}
+
+/**
+* tells the observer, if it is enabled, of an event that started at t0
+* O(1)
+* M(1)
+*/
+void notify(typename DequeEvent::kind_type kind, size_type oldCapacity, size_type newCapacity, size_type count, std::uint64_t t0){
+	if(O::enabled){
+		DequeEvent e = {kind, oldCapacity, newCapacity, count, deque_clock() - t0};
+		O::observe(e);}
+}
+
+/**
+* records n elements moved by an insert or erase in the middle that started at t0
+* O(1)
+* M(1)
+*/
+void noteShift(size_type n, std::uint64_t t0){
+	S::shifted(n);
+	if(n >= O::large_shift)
+		notify(DequeEvent::shift, c, c, n, t0);
+}
+
+/**
+* rotates the outer array in place so that its unused blocks are split evenly
+* between the top and the bottom, finishing any migration first.  only done
+* while at most half of the blocks hold elements, so each side gains at least
+* a quarter of the blocks.  pushes recenter through migrate() instead, and
+* come here only when a bulk operation has used up the room a migration
+* needs.  no elements move.
+* O(outerSize)
+* M(1)
+* @return true if the blocks were rotated
+*/
+bool recenter(){
+	if(empty()){
+		f = c / 2;
+		l = f - 1;
+		return true;}
+	settle();
+	size_type fb = f / block_size;
+	size_type used = (f + size() - 1) / block_size - fb + 1;
+	if(used * 2 > outerSize)
+		return false;
+	size_type t = (outerSize - used) / 2;
+	std::uint64_t t0 = observeStart();
+	if(t > fb){
+		size_type d = t - fb;
+		std::rotate(outer, outer + outerSize - d, outer + outerSize);
+		f += d * block_size;
+		l += d * block_size;
+	}else{
+		size_type d = fb - t;
+		std::rotate(outer, outer + d, outer + outerSize);
+		f -= d * block_size;
+		l -= d * block_size;
+	}
+	notify(DequeEvent::recenter, c, c, outerSize, t0);
+	assert(valid());
+	return true;
+}
+
+/**
+* makes room for one more element at the back and takes a migrate() step;
+* recenters or grows at once only if the room ran out anyway
+* O(1), unless the room ran out
+* M(1), M(n) if a migration starts or the capacity must be increased, where n is the capacity / block_size
+*/
+void ensureBottom(){
+	migrate(bottomCapacity());
+	if(bottomCapacity() == 0){
+		settle();
+		if(bottomCapacity() == 0 && (!recenter() || bottomCapacity() == 0))
+			ensureCapacity(c + 1);}
+}
+
+/**
+* makes room for one more element at the front, as ensureBottom() does at the back
+* O(1), unless the room ran out
+* M(1), M(n) if a migration starts or the capacity must be increased, where n is the capacity / block_size
+*/
+void ensureTop(){
+	migrate(topCapacity());
+	if(topCapacity() == 0){
+		settle();
+		if(topCapacity() == 0 && (!recenter() || topCapacity() == 0))
+			ensureCapacity(c + 1);}
+}
+
+/**
+* moves the first element to the back
+* ~O(1)
+* M(1)
+*/
+void moveFrontToBack(){
+	ensureBottom();
+	pointer p = &(*this)[0];
+	a.construct(slot(f + size()), std::move(*p));
+	a.destroy(p);
+	++f;
+	++l;
+}
+
+/**
+* moves the last element to the front
+* ~O(1)
+* M(1)
+*/
+void moveBackToFront(){
+	ensureTop();
+	pointer p = &(*this)[size() - 1];
+	--f;
+	--l;
+	a.construct(slot(f), std::move(*p));
+	a.destroy(p);
+}
+
+/**
+* grows the Deque until at least n elements can be added to the back without
+* reallocation, leaving migrateRoom() more so that the pushes after them can
+* still grow a few slots at a time
+* O(n), where n is the capacity / block_size.
+* M(n), where n is the requested capacity
+* @param n number of elements to make room for
+*/
+void reserveBottom(size_type n){
+	while(bottomCapacity() < n + migrateRoom())
+		ensureCapacity(c + 2 * (n + migrateRoom() - bottomCapacity()));
+}
+
+/**
+* grows the Deque until at least n elements can be added to the front without
+* reallocation, as reserveBottom() does at the back
+* O(n), where n is the capacity / block_size.
+* M(n), where n is the requested capacity
+* @param n number of elements to make room for
+*/
+void reserveTop(size_type n){
+	while(topCapacity() < n + migrateRoom())
+		ensureCapacity(c + 2 * (n + migrateRoom() - topCapacity()));
+}
+
+/**
+* gives a block to every empty slot covering absolute positions [from, from + n)
+* O(n / block_size)
+* M(n)
+* @param from absolute index of the first position
+* @param n number of positions
+*/
+void allocateBlocks(size_type from, size_type n){
+	if(n == 0)
+		return;
+	for(size_type b = from / block_size; b <= (from + n - 1) / block_size; ++b)
+		if(outer[b] == NULL){
+			outer[b] = allocateBlock();
+			mirror(b);}
+}
+
+/**
+* constructs n elements at the back, a block at a time, growing the Deque and
+* allocating its blocks once beforehand
+* O(n)
+* M(n)
+* @param n number of elements
+* @param make called with the address of each new element, in order, to construct it
+*/
+template <typename F>
+void constructBack(size_type n, F make){
+	reserveBottom(n);
+	allocateBlocks(f + size(), n);
+	size_type i = f + size();
+	const size_type e = i + n;
+	while(i < e){
+		pointer p = outer[i / block_size] + i % block_size;
+		size_type k = std::min(block_size - i % block_size, e - i);
+		for(size_type j = 0; j < k; ++j){
+			make(p + j);
+			++l;
+			++s;}
+#ifndef NDEBUG
+		__instances += k;
+#endif
+		i += k;}
+	S::sized(s);
+}
+
+/**
+* constructs n copies of v at the back, through the allocator
+* O(n)
+* M(n)
+*/
+void fillBack(size_type n, const_reference v, std::false_type){
+	constructBack(n, [&] (pointer p) {
+		a.construct(p, v);});
+}
+
+/**
+* constructs n copies of v at the back for trivially copyable T, a block at a
+* time: with memset when v is one byte repeated, as a value initialized int
+* or double and an int of -1 are, and otherwise with uninitialized_fill_n,
+* which the compiler turns into vector stores.  the allocator's construct is
+* not called, as it would only copy the bytes of a trivially copyable T
+* O(n)
+* M(n)
+*/
+void fillBack(size_type n, const_reference v, std::true_type){
+	reserveBottom(n);
+	allocateBlocks(f + size(), n);
+	const unsigned char* b = reinterpret_cast<const unsigned char*>(&v);
+	bool uniform = true; // v is one byte repeated, as 0 and -1 are
+	for(size_type j = 1; j < sizeof(T); ++j)
+		uniform = uniform && (b[j] == b[0]);
+	const unsigned char byte = b[0];
+	size_type i = f + size();
+	const size_type e = i + n;
+	while(i < e){
+		pointer p = outer[i / block_size] + i % block_size;
+		size_type k = std::min(block_size - i % block_size, e - i);
+		if(uniform)
+			std::memset(static_cast<void*>(p), byte, k * sizeof(T));
+		else
+			std::uninitialized_fill_n(p, k, v);
+		l += k;
+		s += k;
+#ifndef NDEBUG
+		__instances += k;
+#endif
+		i += k;}
+	S::sized(s);
+}
+
+/**
+* assigns from input iterators, one push_back at a time
+*/
+template <typename II>
+void assignRange(II first, II last, std::input_iterator_tag){
+	for(; first != last; ++first)
+		push_back(*first);
+}
+
+/**
+* assigns from forward iterators, sizing the Deque once
+*/
+template <typename FI>
+void assignRange(FI first, FI last, std::forward_iterator_tag){
+	constructBack(std::distance(first, last), [&] (pointer p) {
+		a.construct(p, *first);
+		++first;});
+}
+
+/**
+* empties the Deque without releasing any blocks, positioning the front at the
+* given offset into a block so that it lines up with another Deque's blocks
+* O(1)
+* M(1)
+* @param offset index into a block that the first element will occupy
+*/
+void realign(size_type offset){
+	assert(empty());
+	f = (f / block_size) * block_size + offset;
+	l = f - 1;
+}
+
+/**
+* moves the elements at absolute positions [from, from + n) of that into
+* [to, to + n) of this, where from and to have the same offset into a block.
+* whole blocks are moved by swapping their pointers, which hands this Deque's
+* unused blocks to that; only the elements in a partial first block are moved
+* one at a time.
+* sizes and markers are left to the caller.
+* O(n / block_size + block_size)
+* M(1)
+* @param that a deque using an equal allocator
+* @param from absolute index into that
+* @param to absolute index into this
+* @param n number of elements to move
+*/
+void moveBlocks(Deque& that, size_type from, size_type to, size_type n){
+	assert(from % block_size == to % block_size);
+	size_type i = 0;
+	if(from % block_size){ // copy the partial first block
+		size_type k = block_size - (from % block_size);
+		if(k > n) k = n;
+		for(; i < k; ++i){
+			a.construct(slot(to + i), std::move(that.outer[(from + i) / block_size][(from + i) % block_size]));
+			that.a.destroy(&that.outer[(from + i) / block_size][(from + i) % block_size]);
+		}
+	}
+	for(; i < n; i += block_size){
+		std::swap(outer[(to + i) / block_size], that.outer[(from + i) / block_size]);
+		mirror((to + i) / block_size);
+		that.mirror((from + i) / block_size);}
+#ifndef NDEBUG
+	__instances += n;
+	that.__instances -= n;
+#endif
+}
+
+/**
+* moves the elements at absolute positions [from, from + n) of that into the
+* unconstructed positions [to, to + n) of this, a run at a time, each run
+* ending where either side crosses into a new block.  the moved-from elements
+* are left for the caller to destroy, along with sizes and markers.
+* O(n)
+* M(1)
+* @param that a deque
+* @param from absolute index into that
+* @param to absolute index into this
+* @param n number of elements to move
+*/
+void moveRuns(Deque& that, size_type from, size_type to, size_type n){
+	size_type i = 0;
+	while(i < n){
+		size_type k = block_size - ((from + i) % block_size);
+		if(block_size - ((to + i) % block_size) < k) k = block_size - ((to + i) % block_size);
+		if(n - i < k) k = n - i;
+		std::uninitialized_copy(std::make_move_iterator(&that.outer[(from + i) / block_size][(from + i) % block_size]),
+			std::make_move_iterator(&that.outer[(from + i) / block_size][(from + i) % block_size] + k),
+			slot(to + i));
+		i += k;
+	}
+#ifndef NDEBUG
+	__instances += n;
+#endif
+}
+
+/**
+* destroys the elements at absolute positions [from, from + n), a block at a
+* time; nothing runs for trivially destructible elements.  sizes and markers
+* are left to the caller.
+* O(n), O(1) if trivially destructible
+* M(1)
+* @param from absolute index into this
+* @param n number of elements to destroy
+*/
+void destroyBlocks(size_type from, size_type n){
+	if(!std::is_trivially_destructible<value_type>::value){
+		size_type i = 0;
+		while(i < n){
+			size_type k = block_size - ((from + i) % block_size);
+			if(n - i < k) k = n - i;
+			pointer p = &outer[(from + i) / block_size][(from + i) % block_size];
+			for(size_type j = 0; j < k; ++j)
+				a.destroy(p + j);
+			i += k;
+		}
+	}
+#ifndef NDEBUG
+	__instances -= n;
+#endif
+}
+
 public:
 // -----
 // Deque
@@ -1118,9 +1707,18 @@ Deque (const allocator_type &a = allocator_type())
 		*/
 		Deque (const Deque &that): a(that.a) {
 			init();
-			for(size_type i=0;i<that.size();++i)
-				this->push_back(that[i]);
+			assign(that.begin(), that.end());
+			assert(valid());}
 
+		/**
+		* takes the data of deque that, leaving it empty
+		* O(1)
+		* M(block_size)
+		* @param that a deque
+		*/
+		Deque (Deque &&that): a(that.a) {
+			init();
+			swap(that);
 			assert(valid());}
 
 		// ------
@@ -1133,10 +1731,13 @@ Deque (const allocator_type &a = allocator_type())
 		~Deque (){
 			resize(0);
 			for(difference_type i = 0; i<outerSize;++i)
-				this->a.deallocate(outer[i], block_size);
+				if(outer[i] != NULL)
+					freeBlock(outer[i]);
 
 			typename A::template rebind<pointer>::other x;
 			x.deallocate(outer, outerSize);
+			if(next != NULL)
+				x.deallocate(next, nextSize);
 
 			assert(__instances == 0);
 			assert(valid());}
@@ -1146,21 +1747,29 @@ Deque (const allocator_type &a = allocator_type())
 		// ----------
 		
 		/**
-		* O(n), where n is the size of that
-		* M(n), where n is the size of that
+		* clears this deque, keeping its blocks, and assigns that's elements,
+		* sized once and constructed a block at a time
+		* O(n + m), where n is the size and m the size of that
+		* M(m), where m is the size of that
 		* @param that a deque
 		* @return current deque equal to that deque
 		*/
 		Deque& operator = (const Deque& that){
-			if(this == &that) 
+			if(this == &that)
 				return *this;
-				
-			this->~Deque();
-			
-			init();
-			for(size_type i=0;i<that.size();++i)
-				this->push_back(that[i]);
+			clear();
+			assign(that.begin(), that.end());
+			return *this;}
 
+		/**
+		* takes the data of deque that, which is left with this deque's old data
+		* O(1)
+		* M(1)
+		* @param that a deque
+		* @return current deque
+		*/
+		Deque& operator = (Deque&& that){
+			swap(that);
 			assert(valid());
 			return *this;}
 
@@ -1187,6 +1796,92 @@ Deque (const allocator_type &a = allocator_type())
 		const_reference operator [] (size_type index)const {
 			return const_cast<Deque*>(this)->operator[](index);}
 
+		// ------
+		// append
+		// ------
+
+		/**
+		* moves the elements of that to the back of this deque, leaving that empty.
+		* when the end of this deque and the front of that fall at the same offset
+		* into a block, whole blocks are moved by pointer and only the elements in
+		* that's partial first block are moved one at a time.  otherwise the
+		* smaller of the two is moved, a contiguous run at a time.  both deques must use equal allocators.
+		* O(n / block_size + block_size) if aligned, else O(min(size(), n)), where n is the size of that
+		* M(n / block_size), where n is the size of that
+		* @param that a deque
+		*/
+		void append (Deque&& that){
+			if(this == &that || that.empty())
+				return;
+			if(empty()){
+				swap(that);
+				S::sized(size());
+				return;}
+			if((f + size()) % block_size != that.f % block_size){
+				if(that.size() <= size()){
+					size_type n = that.size();
+					reserveBottom(n);
+					moveRuns(that, that.f, f + size(), n);
+					s += n;
+					l += n;
+					that.clear();
+				}else{
+					size_type n = size();
+					that.reserveTop(n);
+					that.moveRuns(*this, f, that.f - n, n);
+					that.f -= n;
+					that.s += n;
+					clear();
+					swap(that);
+				}
+				S::sized(size());
+				assert(valid());
+				return;}
+
+			size_type n = that.size();
+			reserveBottom(n);
+			moveBlocks(that, that.f, f + size(), n);
+			s += n;
+			l += n;
+			that.s = 0;
+			that.l = that.f - 1;
+			S::sized(size());
+			assert(valid());
+			assert(that.valid());}
+
+		/**
+		* appends n elements made by g, growing once and then constructing them a
+		* block at a time
+		* O(n)
+		* M(n)
+		* @param n number of elements
+		* @param g called n times, in order, for the values of the new elements
+		*/
+		template <typename G>
+		void append_n (size_type n, G g){
+			constructBack(n, [&] (pointer p) {
+				a.construct(p, g());});
+			assert(valid());}
+
+		// ------
+		// assign
+		// ------
+
+		/**
+		* replaces the elements with those of [first, last), which must not lie in
+		* this deque.  given forward iterators, it sizes the deque once and
+		* constructs the elements a block at a time.
+		* O(n + m), where n is the size and m is the length of the range
+		* M(m)
+		* @param first iterator position of the first element
+		* @param last iterator position one past the last element
+		*/
+		template <typename II>
+		void assign (II first, II last){
+			clear();
+			assignRange(first, last, typename std::iterator_traits<II>::iterator_category());
+			assert(valid());}
+
 		// --
 		// at
 		// --
@@ -1320,34 +2015,73 @@ Deque (const allocator_type &a = allocator_type())
 		*/
 		iterator erase (iterator i){
 			if(i == end()-1){ //remove from the end
+				a.destroy(&(*i));
 				--l; // decrement last position marker by 1 if removing from the back
 				--s; // decrement size
 			}else if (i == begin()){
+				a.destroy(&(*i));
 				++f; // increment front position marker by 1 if removing from the front
 				--s; // decrement size
 			}else{ // removing from the middle
-#ifndef NDEBUG
-				++__instances;
-#endif
+				std::uint64_t t0 = observeStart();
+				size_type n;
 				if(i < middle()){ // easier to reposition from middle towards front
+					n = i.cur;
 					for(difference_type j=i.cur; j>0; --j){
-						std::swap((*this)[j], (*this)[j-1]);
+						(*this)[j] = std::move((*this)[j-1]);
 					}
 					pop_front();
 				}else{ // easier to reposition from the middle towards back
-					for(difference_type j=i.cur; j<size(); ++j){
-						std::swap((*this)[j], (*this)[j+1]);
+					n = size() - 1 - i.cur;
+					for(size_type j=i.cur; j+1<size(); ++j){
+						(*this)[j] = std::move((*this)[j+1]);
 					}
 					pop_back();
 				}
+				noteShift(n, t0);
+				return i;
 			}
-			a.destroy(&(*i));
 #ifndef NDEBUG
 			--__instances;
 #endif
 
 			return i;}
 
+		/**
+		* erases the elements in [first, last), moving the elements on the shorter
+		* side of the range into it.  erasing a prefix or a suffix moves nothing:
+		* the front or back marker skips the run in one step, and the blocks it
+		* covered are left for later pushes to reuse.
+		* O(k + min(i, n - j)) for the range [i, j) of k elements, O(1) for a prefix
+		* or suffix of trivially destructible elements
+		* M(1)
+		* @param first iterator position of the first element to erase
+		* @param last iterator position one past the last element to erase
+		* @return iterator position of the element that followed the range
+		*/
+		iterator erase (iterator first, iterator last){
+			size_type i = first.cur;
+			size_type k = last.cur - first.cur;
+			if(k == 0)
+				return first;
+			std::uint64_t t0 = observeStart();
+			size_type n;
+			if(i < size() - last.cur){ // fewer elements before the range
+				n = i;
+				std::move_backward(begin(), first, last);
+				destroyBlocks(f, k);
+				f += k;
+			}else{
+				n = size() - last.cur;
+				std::move(last, end(), first);
+				destroyBlocks(l - k + 1, k);
+				l -= k;
+			}
+			s -= k;
+			noteShift(n, t0);
+			assert(valid());
+			return begin() + i;}
+
 		// -----
 		// front
 		// -----
@@ -1380,33 +2114,38 @@ Deque (const allocator_type &a = allocator_type())
 		iterator insert (iterator i, const_reference v){
 			assert(valid());
 			if(i == end()){ //insert at the end
-				if(bottomCapacity() == 0) ensureCapacity(c + 1);
+				ensureBottom();
 				++l; // increment last position marker by 1 if adding to the back
 				++s; // increment size
+				S::sized(s);
 			}else if (i == begin()){
-				if(topCapacity() == 0) ensureCapacity(c + 1);
+				ensureTop();
 				--f; // decrement front position marker by 1 if adding to the front
 				++s; // increment size
+				S::sized(s);
 			}else{ // inserting into the middle
-#ifndef NDEBUG
-				--__instances;
-#endif
+				value_type t = v; // v may be an element of this deque
+				std::uint64_t t0 = observeStart();
+				size_type n;
 				if(i < middle()){ // easier to reposition from middle towards front
-					if(topCapacity() == 0) ensureCapacity(c + 1);
-					push_front(*begin());
-					for(iterator j=begin(); j<=i; ++j){
-						std::swap(*j, *(j+1));
+					n = i.cur;
+					push_front(front());
+					for(difference_type j=1; j<i.cur; ++j){
+						(*this)[j] = std::move((*this)[j+1]);
 					}
 				}else{ // easier to reposition from the middle towards back
-					if(bottomCapacity() == 0) ensureCapacity(c + 1);
-					push_back(*(--end()));
-					for(iterator j=--end(); j>i; --j){
-						std::swap(*j, *(j-1));
+					n = size() - i.cur;
+					push_back(back());
+					for(difference_type j=size()-2; j>i.cur; --j){
+						(*this)[j] = std::move((*this)[j-1]);
 					}
 				}
+				*i = std::move(t);
+				noteShift(n, t0);
+				return i;
 			}
 
-			a.construct(&(*i), v);
+			a.construct(slot(f + i.cur), v);
 #ifndef NDEBUG
 			++__instances;
 #endif
@@ -1432,6 +2171,114 @@ Deque (const allocator_type &a = allocator_type())
 			erase(begin());
 			assert(valid());}
 
+		/**
+		* moves up to n elements off the front into out, in order, a block at a
+		* time, then destroys what is left of them in one pass
+		* O(n)
+		* M(1)
+		* @param n most elements to pop
+		* @param out where the elements are moved to
+		* @return out, past the last element written
+		*/
+		template <typename OI>
+		OI pop_front_n (size_type n, OI out){
+			if(n > size())
+				n = size();
+			for(size_type i = 0; i < n; ){
+				size_type k = std::min(segment_length(i), n - i);
+				pointer p = &(*this)[i];
+				out = std::move(p, p + k, out);
+				i += k;}
+			destroyBlocks(f, n);
+			f += n;
+			s -= n;
+			assert(valid());
+			return out;}
+
+		/**
+		* moves up to n elements off the back into out, in the order they had in
+		* the deque, front to back, as pop_front_n does at the front
+		* O(n)
+		* M(1)
+		* @param n most elements to pop
+		* @param out where the elements are moved to
+		* @return out, past the last element written
+		*/
+		template <typename OI>
+		OI pop_back_n (size_type n, OI out){
+			if(n > size())
+				n = size();
+			for(size_type i = size() - n; i < size(); ){
+				size_type k = segment_length(i);
+				pointer p = &(*this)[i];
+				out = std::move(p, p + k, out);
+				i += k;}
+			destroyBlocks(l - n + 1, n);
+			l -= n;
+			s -= n;
+			assert(valid());
+			return out;}
+
+		// -------------
+		// discard_front
+		// -------------
+
+		/**
+		* drops up to n elements off the front.  the front marker skips them in
+		* one step; their blocks stay with the deque for later pushes to reuse.
+		* O(n), O(1) if trivially destructible
+		* M(1)
+		* @param n most elements to drop
+		*/
+		void discard_front (size_type n){
+			if(n > size())
+				n = size();
+			destroyBlocks(f, n);
+			f += n;
+			s -= n;
+			assert(valid());}
+
+		// -----
+		// drain
+		// -----
+
+		/**
+		* hands every element to g, one contiguous segment at a time, front to
+		* back, and then empties the deque.  g may move from the elements; they
+		* are destroyed after it has seen them all.
+		* O(n), and O(n / block_size) calls to g
+		* M(1)
+		* @param g called as g(p, k) for each segment of k elements starting at p
+		*/
+		template <typename G>
+		void drain (G g){
+			for(size_type i = 0; i < size(); ){
+				size_type k = segment_length(i);
+				g(&(*this)[i], k);
+				i += k;}
+			destroyBlocks(f, size());
+			l = f - 1;
+			s = 0;
+			assert(valid());}
+
+		// -------
+		// prepend
+		// -------
+
+		/**
+		* moves the elements of that to the front of this deque, leaving that empty.
+		* same alignment rules and cost as append.
+		* O(n / block_size + block_size) if aligned, else O(min(size(), n)), where n is the size of that
+		* M(size() / block_size)
+		* @param that a deque
+		*/
+		void prepend (Deque&& that){
+			if(this == &that || that.empty())
+				return;
+			that.append(std::move(*this));
+			swap(that);
+			assert(valid());}
+
 		// ----
 		// push
 		// ----
@@ -1457,6 +2304,9 @@ Deque (const allocator_type &a = allocator_type())
 		// resize
 		// ------
 		/**
+		* grows by constructing the new elements a block at a time; trivially
+		* copyable elements are written with memset when the value is one byte
+		* repeated, else with uninitialized_fill_n
 		* O(n), where n = abs(new size - current size) 
 		* M(n), where n = new size - current size
 		* @param s new size of deque
@@ -1475,18 +2325,126 @@ Deque (const allocator_type &a = allocator_type())
 				l = f + s - 1;
 				this->s = s;
 			}else{
-				for(size_type i = size(); i < s; ++i){
-					if(bottomCapacity() == 0) ensureCapacity(c + 1);
-					++l;
-					a.construct(&(*this)[i], v);
-#ifndef NDEBUG
-					++__instances;
-#endif
-					++this->s;
-				}
+				fillBack(s - size(), v, std::integral_constant<bool, std::is_trivially_copyable<T>::value>());
 			}
 			assert(valid());}
 
+		// -------
+		// reserve
+		// -------
+
+		/**
+		* makes room for a size of n without growing, at the back
+		* O(n / block_size)
+		* M(n)
+		* @param n size to make room for
+		*/
+		void reserve (size_type n){
+			if(n > size())
+				reserve_back(n - size());}
+
+		/**
+		* makes room for n more elements at the back, finishing any migration,
+		* growing the outer array at most once and allocating their blocks, so
+		* the next n pushes at the back neither grow nor allocate
+		* O(n / block_size), plus O(capacity / block_size) if the outer array grows or a migration is under way
+		* M(n)
+		* @param n number of elements to make room for
+		*/
+		void reserve_back (size_type n){
+			settle();
+			reserveBottom(n);
+			allocateBlocks(f + size(), n);
+			assert(valid());}
+
+		/**
+		* makes room for n more elements at the front, as reserve_back does at the back
+		* O(n / block_size), plus O(capacity / block_size) if the outer array grows or a migration is under way
+		* M(n)
+		* @param n number of elements to make room for
+		*/
+		void reserve_front (size_type n){
+			settle();
+			reserveTop(n);
+			allocateBlocks(f - n, n);
+			assert(valid());}
+
+		// --------
+		// capacity
+		// --------
+
+		/**
+		* O(1)
+		* M(1)
+		* @return number of elements the outer array has slots for
+		*/
+		size_type capacity ()const {
+			return c;}
+
+		// ------
+		// rotate
+		// ------
+
+		/**
+		* rotates the deque left by k, so the element at position k becomes the first,
+		* as std::rotate(begin(), begin() + k, end()) would.  when the size is a
+		* multiple of the block size, up to block_size - 1 elements move to bring
+		* the front to a block boundary and up to block_size - 1 more after the
+		* block pointers are rotated, so at most 2 * block_size - 2 in all;
+		* otherwise min(k, size() - k) elements move from one end to the other.
+		* O(size() / block_size + block_size) if block aligned, else O(min(k, size() - k))
+		* M(1)
+		* @param k number of positions to rotate by, taken modulo size()
+		*/
+		void rotate (size_type k){
+			if(size() == 0 || (k %= size()) == 0)
+				return;
+			bool aligned = (size() % block_size == 0);
+			if(k <= size() - k){
+				if(aligned){
+					for(; k > 0 && f % block_size; --k)
+						moveFrontToBack();
+					size_type fb = f / block_size;
+					size_type q = k / block_size;
+					std::rotate(outer + fb, outer + fb + q, outer + fb + size() / block_size);
+					for(size_type b = fb; b < fb + size() / block_size; ++b)
+						mirror(b);
+					k -= q * block_size;}
+				for(; k > 0; --k)
+					moveFrontToBack();
+			}else{
+				size_type j = size() - k;
+				if(aligned){
+					for(; j > 0 && f % block_size; --j)
+						moveBackToFront();
+					size_type fb = f / block_size;
+					size_type lb = fb + size() / block_size;
+					size_type q = j / block_size;
+					std::rotate(outer + fb, outer + lb - q, outer + lb);
+					for(size_type b = fb; b < lb; ++b)
+						mirror(b);
+					j -= q * block_size;}
+				for(; j > 0; --j)
+					moveBackToFront();
+			}
+			assert(valid());}
+
+		// --------------
+		// segment_length
+		// --------------
+
+		/**
+		* elements [index, index + segment_length(index)) are contiguous in memory,
+		* so &(*this)[index] can be handed to code that walks a plain array.
+		* O(1)
+		* M(1)
+		* @param index element index, less than size()
+		* @return number of elements from index to the end of its block or of the deque
+		*/
+		size_type segment_length (size_type index)const {
+			size_type n = block_size - (f + index) % block_size;
+			return (n < size() - index) ? n : size() - index;}
+
 		// ----
 		// size
 		// ----
@@ -1498,11 +2456,100 @@ Deque (const allocator_type &a = allocator_type())
 		size_type size ()const {
 			return s;}
 
+		// ------
+		// splice
+		// ------
+
+		/**
+		* moves the elements of that into this deque before position i, leaving that empty.
+		* implemented as split_at, append, append, so whole blocks move wherever the
+		* pieces line up.
+		* O(n / block_size + block_size) if aligned, where n is the size of both deques
+		* M(n / block_size), where n is the size of both deques
+		* @param i iterator position
+		* @param that a deque
+		*/
+		void splice (iterator i, Deque&& that){
+			if(this == &that || that.empty())
+				return;
+			Deque tail = split_at(i.cur);
+			append(std::move(that));
+			append(std::move(tail));}
+
+		// --------
+		// split_at
+		// --------
+
+		/**
+		* removes the elements at positions [index, size()) and returns them as a new deque.
+		* whole blocks are moved by pointer; only the elements in the block holding
+		* index are moved one at a time.
+		* O((size() - index) / block_size + block_size)
+		* M((size() - index) / block_size)
+		* @param index position of the first element to move
+		* @throw std::out_of_range
+		* @return a deque holding the removed elements
+		*/
+		Deque split_at (size_type index){
+			if(index > size())
+				throw std::out_of_range("deque split_at out of range");
+			Deque r(a);
+			size_type n = size() - index;
+			if(n == 0)
+				return r;
+			r.realign((f + index) % block_size);
+			r.reserveBottom(n);
+			r.moveBlocks(*this, f + index, r.f, n);
+			r.s = n;
+			r.l = r.f + n - 1;
+			r.S::sized(n);
+			s = index;
+			l = f + index - 1;
+			assert(valid());
+			assert(r.valid());
+			return r;}
+
+		// -----
+		// stats
+		// -----
+
+		/**
+		* copies the statistics policy and has the copy measure the bytes used
+		* and reserved now, leaving this deque untouched; see DequeStats.h
+		* O(outerSize)
+		* M(1)
+		* @return a snapshot of the statistics gathered by this deque
+		*/
+		S stats ()const {
+			size_type blocks = 0;
+			for(size_type i = 0; i < outerSize; ++i)
+				if(outer[i] != NULL)
+					++blocks;
+			S r = *this;
+			r.measured(size() * sizeof(T), blocks * block_size * sizeof(T) + (outerSize + (next ? nextSize : 0)) * sizeof(pointer), c);
+			return r;}
+
+		// --------
+		// observer
+		// --------
+
+		/**
+		* O(1)
+		* M(1)
+		* @return the observer policy, e.g. a RingTracer to read back
+		*/
+		O& observer (){
+			return *this;}
+
+		const O& observer ()const {
+			return *this;}
+
 		// ----
 		// swap
 		// ----
 		/**
-		* swaps the data of this deque and that deque
+		* swaps the data of this deque and that deque; the statistics and the
+		* observer stay with each deque
 		* O(1)
 		* M(1)
 		* @param that a deque
@@ -1518,6 +2565,10 @@ Deque (const allocator_type &a = allocator_type())
 						
 			std::swap(this->outerSize, that.outerSize);
 			std::swap(this->outer, that.outer);
+			std::swap(this->next, that.next);
+			std::swap(this->nextSize, that.nextSize);
+			std::swap(this->nextShift, that.nextShift);
+			std::swap(this->filled, that.filled);
 			std::swap(this->a, that.a);
 
 			assert(valid());}};
@@ -1526,7 +2577,7 @@ Deque (const allocator_type &a = allocator_type())
 			// swap
 			// ----
 
-			template <typename T, typename A>
+			template <typename T, typename A, typename S, typename O>
 				/**
 				* swaps the data of deque x and deque y
 				* O(1)
@@ -1534,7 +2585,7 @@ Deque (const allocator_type &a = allocator_type())
 				* @param x a deque
 				* @param y another deque
 				*/		
-				void swap (Deque<T, A>& x, Deque<T, A>& y){
+				void swap (Deque<T, A, S, O>& x, Deque<T, A, S, O>& y){
 					x.swap(y);}
 
 } // deque
@@ -0,0 +1,517 @@
+// ---------------------------
+// prog/deque/DequeAlgorithm.h
+// Tj Wrenn
+// ---------------------------
+
+#ifndef DequeAlgorithm_h
+#define DequeAlgorithm_h
+
+// --------
+// includes
+// --------
+
+#include <algorithm> // find, count, min_element, max_element
+#include <cstddef> // size_t
+#include <numeric> // accumulate
+#include <type_traits> // is_same, true_type, false_type
+
+#include "Deque.h"
+
+#if (defined(__x86_64__) || defined(__i386__)) && defined(__GNUC__)
+#define DEQUE_SIMD_X86 1
+#include <immintrin.h>
+#endif
+
+// ----------
+// namespaces
+// ----------
+
+namespace dt{
+namespace prog{
+namespace deque{
+
+// -------
+// kernels
+// -------
+
+/**
+* Loops over one contiguous segment of a Deque.  The generic versions are
+* plain loops, which the compiler vectorizes for the baseline instruction set
+* where it can; int and double get hand-written AVX2 versions that are picked
+* at run time when the CPU supports them.
+*/
+namespace kernels{
+
+// -------
+// generic
+// -------
+
+template <typename T>
+const T* find (const T* p, std::size_t n, const T& v){
+	for(std::size_t i = 0; i < n; ++i)
+		if(p[i] == v)
+			return p + i;
+	return p + n;}
+
+template <typename T>
+std::size_t count (const T* p, std::size_t n, const T& v){
+	std::size_t r = 0;
+	for(std::size_t i = 0; i < n; ++i)
+		r += (p[i] == v);
+	return r;}
+
+template <typename T>
+T sum (const T* p, std::size_t n){
+	T r = T();
+	for(std::size_t i = 0; i < n; ++i)
+		r = r + p[i];
+	return r;}
+
+/**
+* @return the smallest of r and the elements, keeping the earlier of equivalent values as std::min_element does
+*/
+template <typename T>
+T min (const T* p, std::size_t n, T r){
+	for(std::size_t i = 0; i < n; ++i)
+		if(p[i] < r)
+			r = p[i];
+	return r;}
+
+/**
+* @return the largest of r and the elements, keeping the earlier of equivalent values as std::max_element does
+*/
+template <typename T>
+T max (const T* p, std::size_t n, T r){
+	for(std::size_t i = 0; i < n; ++i)
+		if(r < p[i])
+			r = p[i];
+	return r;}
+
+/**
+* @return pointer to the first element equivalent to v under <, or p + n
+*/
+template <typename T>
+const T* locate (const T* p, std::size_t n, const T& v){
+	for(std::size_t i = 0; i < n; ++i)
+		if(!(p[i] < v) && !(v < p[i]))
+			return p + i;
+	return p + n;}
+
+#ifdef DEQUE_SIMD_X86
+// ----
+// avx2
+// ----
+
+/**
+* @return true if the CPU running us supports AVX2
+*/
+inline bool has_avx2 (){
+	static const bool r = __builtin_cpu_supports("avx2");
+	return r;}
+
+__attribute__((target("avx2")))
+inline int hsum (__m256i x){
+	__m128i y = _mm_add_epi32(_mm256_castsi256_si128(x), _mm256_extracti128_si256(x, 1));
+	y = _mm_add_epi32(y, _mm_shuffle_epi32(y, 0x4e));
+	y = _mm_add_epi32(y, _mm_shuffle_epi32(y, 0xb1));
+	return _mm_cvtsi128_si32(y);}
+
+__attribute__((target("avx2")))
+inline const int* find_avx2 (const int* p, std::size_t n, int v){
+	__m256i x = _mm256_set1_epi32(v);
+	std::size_t i = 0;
+	for(; i + 8 <= n; i += 8){
+		__m256i y = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(p + i));
+		int m = _mm256_movemask_ps(_mm256_castsi256_ps(_mm256_cmpeq_epi32(x, y)));
+		if(m)
+			return p + i + __builtin_ctz(m);}
+	return find<int>(p + i, n - i, v);}
+
+__attribute__((target("avx2")))
+inline std::size_t count_avx2 (const int* p, std::size_t n, int v){
+	__m256i x = _mm256_set1_epi32(v);
+	__m256i r = _mm256_setzero_si256();
+	std::size_t i = 0;
+	for(; i + 8 <= n; i += 8)
+		r = _mm256_sub_epi32(r, _mm256_cmpeq_epi32(x, _mm256_loadu_si256(reinterpret_cast<const __m256i*>(p + i))));
+	return (unsigned)hsum(r) + count<int>(p + i, n - i, v);}
+
+__attribute__((target("avx2")))
+inline int sum_avx2 (const int* p, std::size_t n){
+	__m256i r = _mm256_setzero_si256();
+	std::size_t i = 0;
+	for(; i + 8 <= n; i += 8)
+		r = _mm256_add_epi32(r, _mm256_loadu_si256(reinterpret_cast<const __m256i*>(p + i)));
+	return (int)((unsigned)hsum(r) + (unsigned)sum<int>(p + i, n - i));}
+
+__attribute__((target("avx2")))
+inline int min_avx2 (const int* p, std::size_t n, int v){
+	if(n < 8)
+		return min<int>(p, n, v);
+	__m256i r = _mm256_set1_epi32(v);
+	std::size_t i = 0;
+	for(; i + 8 <= n; i += 8)
+		r = _mm256_min_epi32(r, _mm256_loadu_si256(reinterpret_cast<const __m256i*>(p + i)));
+	r = _mm256_min_epi32(r, _mm256_loadu_si256(reinterpret_cast<const __m256i*>(p + n - 8)));
+	__m128i y = _mm_min_epi32(_mm256_castsi256_si128(r), _mm256_extracti128_si256(r, 1));
+	y = _mm_min_epi32(y, _mm_shuffle_epi32(y, 0x4e));
+	y = _mm_min_epi32(y, _mm_shuffle_epi32(y, 0xb1));
+	return _mm_cvtsi128_si32(y);}
+
+__attribute__((target("avx2")))
+inline int max_avx2 (const int* p, std::size_t n, int v){
+	if(n < 8)
+		return max<int>(p, n, v);
+	__m256i r = _mm256_set1_epi32(v);
+	std::size_t i = 0;
+	for(; i + 8 <= n; i += 8)
+		r = _mm256_max_epi32(r, _mm256_loadu_si256(reinterpret_cast<const __m256i*>(p + i)));
+	r = _mm256_max_epi32(r, _mm256_loadu_si256(reinterpret_cast<const __m256i*>(p + n - 8)));
+	__m128i y = _mm_max_epi32(_mm256_castsi256_si128(r), _mm256_extracti128_si256(r, 1));
+	y = _mm_max_epi32(y, _mm_shuffle_epi32(y, 0x4e));
+	y = _mm_max_epi32(y, _mm_shuffle_epi32(y, 0xb1));
+	return _mm_cvtsi128_si32(y);}
+
+__attribute__((target("avx2")))
+inline const double* find_avx2 (const double* p, std::size_t n, double v){
+	__m256d x = _mm256_set1_pd(v);
+	std::size_t i = 0;
+	for(; i + 4 <= n; i += 4){
+		int m = _mm256_movemask_pd(_mm256_cmp_pd(x, _mm256_loadu_pd(p + i), _CMP_EQ_OQ));
+		if(m)
+			return p + i + __builtin_ctz(m);}
+	return find<double>(p + i, n - i, v);}
+
+__attribute__((target("avx2")))
+inline std::size_t count_avx2 (const double* p, std::size_t n, double v){
+	__m256d x = _mm256_set1_pd(v);
+	std::size_t r = 0;
+	std::size_t i = 0;
+	for(; i + 4 <= n; i += 4)
+		r += __builtin_popcount(_mm256_movemask_pd(_mm256_cmp_pd(x, _mm256_loadu_pd(p + i), _CMP_EQ_OQ)));
+	return r + count<double>(p + i, n - i, v);}
+
+/**
+* adds four interleaved partial sums, so the result can differ from a
+* left-to-right sum in the last bits
+*/
+__attribute__((target("avx2")))
+inline double sum_avx2 (const double* p, std::size_t n){
+	__m256d r = _mm256_setzero_pd();
+	std::size_t i = 0;
+	for(; i + 4 <= n; i += 4)
+		r = _mm256_add_pd(r, _mm256_loadu_pd(p + i));
+	__m128d y = _mm_add_pd(_mm256_castpd256_pd128(r), _mm256_extractf128_pd(r, 1));
+	y = _mm_add_sd(y, _mm_unpackhi_pd(y, y));
+	return _mm_cvtsd_f64(y) + sum<double>(p + i, n - i);}
+
+/**
+* _mm256_min_pd and _mm256_max_pd pass NaN through depending on the lane it
+* lands in, so a NaN v or a segment holding a NaN takes the scalar loop,
+* whose < keeps the first winner as std::min_element does
+*/
+__attribute__((target("avx2")))
+inline double min_avx2 (const double* p, std::size_t n, double v){
+	if(n < 4 || v != v)
+		return min<double>(p, n, v);
+	__m256d r = _mm256_set1_pd(v);
+	__m256d nan = _mm256_setzero_pd();
+	std::size_t i = 0;
+	for(; i + 4 <= n; i += 4){
+		__m256d x = _mm256_loadu_pd(p + i);
+		nan = _mm256_or_pd(nan, _mm256_cmp_pd(x, x, _CMP_UNORD_Q));
+		r = _mm256_min_pd(r, x);}
+	__m256d x = _mm256_loadu_pd(p + n - 4);
+	nan = _mm256_or_pd(nan, _mm256_cmp_pd(x, x, _CMP_UNORD_Q));
+	if(_mm256_movemask_pd(nan))
+		return min<double>(p, n, v);
+	r = _mm256_min_pd(r, x);
+	__m128d y = _mm_min_pd(_mm256_castpd256_pd128(r), _mm256_extractf128_pd(r, 1));
+	return _mm_cvtsd_f64(_mm_min_sd(y, _mm_unpackhi_pd(y, y)));}
+
+__attribute__((target("avx2")))
+inline double max_avx2 (const double* p, std::size_t n, double v){
+	if(n < 4 || v != v)
+		return max<double>(p, n, v);
+	__m256d r = _mm256_set1_pd(v);
+	__m256d nan = _mm256_setzero_pd();
+	std::size_t i = 0;
+	for(; i + 4 <= n; i += 4){
+		__m256d x = _mm256_loadu_pd(p + i);
+		nan = _mm256_or_pd(nan, _mm256_cmp_pd(x, x, _CMP_UNORD_Q));
+		r = _mm256_max_pd(r, x);}
+	__m256d x = _mm256_loadu_pd(p + n - 4);
+	nan = _mm256_or_pd(nan, _mm256_cmp_pd(x, x, _CMP_UNORD_Q));
+	if(_mm256_movemask_pd(nan))
+		return max<double>(p, n, v);
+	r = _mm256_max_pd(r, x);
+	__m128d y = _mm_max_pd(_mm256_castpd256_pd128(r), _mm256_extractf128_pd(r, 1));
+	return _mm_cvtsd_f64(_mm_max_sd(y, _mm_unpackhi_pd(y, y)));}
+
+// --------
+// dispatch
+// --------
+
+inline const int* find (const int* p, std::size_t n, const int& v){
+	return has_avx2() ? find_avx2(p, n, v) : find<int>(p, n, v);}
+
+inline std::size_t count (const int* p, std::size_t n, const int& v){
+	return has_avx2() ? count_avx2(p, n, v) : count<int>(p, n, v);}
+
+inline int sum (const int* p, std::size_t n){
+	return has_avx2() ? sum_avx2(p, n) : sum<int>(p, n);}
+
+inline int min (const int* p, std::size_t n, int v){
+	return has_avx2() ? min_avx2(p, n, v) : min<int>(p, n, v);}
+
+inline int max (const int* p, std::size_t n, int v){
+	return has_avx2() ? max_avx2(p, n, v) : max<int>(p, n, v);}
+
+inline const double* find (const double* p, std::size_t n, const double& v){
+	return has_avx2() ? find_avx2(p, n, v) : find<double>(p, n, v);}
+
+inline std::size_t count (const double* p, std::size_t n, const double& v){
+	return has_avx2() ? count_avx2(p, n, v) : count<double>(p, n, v);}
+
+inline double sum (const double* p, std::size_t n){
+	return has_avx2() ? sum_avx2(p, n) : sum<double>(p, n);}
+
+inline double min (const double* p, std::size_t n, double v){
+	return has_avx2() ? min_avx2(p, n, v) : min<double>(p, n, v);}
+
+inline double max (const double* p, std::size_t n, double v){
+	return has_avx2() ? max_avx2(p, n, v) : max<double>(p, n, v);}
+
+inline const int* locate (const int* p, std::size_t n, const int& v){
+	return find(p, n, v);}
+
+/**
+* a NaN minimum or maximum is equivalent to every element under <, as the
+* generic locate finds it
+*/
+inline const double* locate (const double* p, std::size_t n, const double& v){
+	return (v == v) ? find(p, n, v) : locate<double>(p, n, v);}
+#endif
+
+} // kernels
+
+// ----
+// find
+// ----
+
+/**
+* O(n), where n = last - first
+* M(1)
+* @param d a deque
+* @param first index of the first element to look at
+* @param last index one past the last element to look at
+* @param v value to look for
+* @return iterator to the first element in [first, last) equal to v, or to last
+*/
+template <typename T, typename A, typename S, typename O>
+typename Deque<T, A, S, O>::const_iterator find (const Deque<T, A, S, O>& d, typename Deque<T, A, S, O>::size_type first, typename Deque<T, A, S, O>::size_type last, const typename Deque<T, A, S, O>::value_type& v){
+	while(first < last){
+		typename Deque<T, A, S, O>::size_type n = d.segment_length(first);
+		if(n > last - first) n = last - first;
+		const T* p = &d[first];
+		const T* q = kernels::find(p, n, v);
+		if(q != p + n)
+			return d.begin() + (first + (q - p));
+		first += n;}
+	return d.begin() + last;}
+
+/**
+* O(n), where n is the size of d
+* M(1)
+* @param d a deque
+* @param v value to look for
+* @return iterator to the first element equal to v, or end()
+*/
+template <typename T, typename A, typename S, typename O>
+typename Deque<T, A, S, O>::const_iterator find (const Deque<T, A, S, O>& d, const typename Deque<T, A, S, O>::value_type& v){
+	return find(d, 0, d.size(), v);}
+
+// -----
+// count
+// -----
+
+/**
+* O(n), where n = last - first
+* M(1)
+* @param d a deque
+* @param first index of the first element to look at
+* @param last index one past the last element to look at
+* @param v value to count
+* @return number of elements in [first, last) equal to v
+*/
+template <typename T, typename A, typename S, typename O>
+typename Deque<T, A, S, O>::difference_type count (const Deque<T, A, S, O>& d, typename Deque<T, A, S, O>::size_type first, typename Deque<T, A, S, O>::size_type last, const typename Deque<T, A, S, O>::value_type& v){
+	typename Deque<T, A, S, O>::difference_type r = 0;
+	while(first < last){
+		typename Deque<T, A, S, O>::size_type n = d.segment_length(first);
+		if(n > last - first) n = last - first;
+		r += kernels::count(&d[first], n, v);
+		first += n;}
+	return r;}
+
+/**
+* O(n), where n is the size of d
+* M(1)
+* @param d a deque
+* @param v value to count
+* @return number of elements equal to v
+*/
+template <typename T, typename A, typename S, typename O>
+typename Deque<T, A, S, O>::difference_type count (const Deque<T, A, S, O>& d, const typename Deque<T, A, S, O>::value_type& v){
+	return count(d, 0, d.size(), v);}
+
+// ----------
+// accumulate
+// ----------
+
+namespace kernels{
+
+/**
+* adds the segment's kernel sum to init when init has the element type
+*/
+template <typename T>
+T add (T init, const T* p, std::size_t n, std::true_type){
+	return init + sum(p, n);}
+
+/**
+* adds the elements to init one at a time, in init's type
+*/
+template <typename V, typename T>
+V add (V init, const T* p, std::size_t n, std::false_type){
+	for(std::size_t i = 0; i < n; ++i)
+		init = init + p[i];
+	return init;}
+
+} // kernels
+
+/**
+* accumulates in V, as std::accumulate does.  when V is T each segment is
+* summed with the kernel and the segment sums are added to init; for floating
+* point T the additions are regrouped, so the result can differ from
+* std::accumulate's in the last bits.
+* O(n), where n = last - first
+* M(1)
+* @param d a deque
+* @param first index of the first element to add
+* @param last index one past the last element to add
+* @param init initial value
+* @return init plus the elements in [first, last)
+*/
+template <typename T, typename A, typename S, typename O, typename V>
+V accumulate (const Deque<T, A, S, O>& d, typename Deque<T, A, S, O>::size_type first, typename Deque<T, A, S, O>::size_type last, V init){
+	while(first < last){
+		typename Deque<T, A, S, O>::size_type n = d.segment_length(first);
+		if(n > last - first) n = last - first;
+		init = kernels::add(init, &d[first], n, std::is_same<V, T>());
+		first += n;}
+	return init;}
+
+/**
+* O(n), where n is the size of d
+* M(1)
+* @param d a deque
+* @param init initial value
+* @return init plus every element
+*/
+template <typename T, typename A, typename S, typename O, typename V>
+V accumulate (const Deque<T, A, S, O>& d, V init){
+	return accumulate(d, 0, d.size(), init);}
+
+// ------------------------
+// min_element, max_element
+// ------------------------
+
+/**
+* carries the smallest value so far into each segment's kernel, so the
+* segments see the same comparisons as one std::min_element scan (which
+* matters for NaN), then finds the first position holding that value
+* O(n), where n = last - first
+* M(1)
+* @param d a deque
+* @param first index of the first element to look at
+* @param last index one past the last element to look at
+* @return iterator to the first smallest element in [first, last), or to last if the range is empty
+*/
+template <typename T, typename A, typename S, typename O>
+typename Deque<T, A, S, O>::const_iterator min_element (const Deque<T, A, S, O>& d, typename Deque<T, A, S, O>::size_type first, typename Deque<T, A, S, O>::size_type last){
+	typedef typename Deque<T, A, S, O>::size_type size_type;
+	if(first >= last)
+		return d.begin() + last;
+	T m = d[first];
+	size_type best = first;
+	size_type bestLength = d.segment_length(first);
+	if(bestLength > last - first) bestLength = last - first;
+	while(first < last){
+		size_type n = d.segment_length(first);
+		if(n > last - first) n = last - first;
+		T x = kernels::min(&d[first], n, m);
+		if(x < m){
+			m = x;
+			best = first;
+			bestLength = n;}
+		first += n;}
+	const T* p = &d[best];
+	return d.begin() + (best + (kernels::locate(p, bestLength, m) - p));}
+
+/**
+* O(n), where n is the size of d
+* M(1)
+* @param d a deque
+* @return iterator to the first smallest element, or end() if d is empty
+*/
+template <typename T, typename A, typename S, typename O>
+typename Deque<T, A, S, O>::const_iterator min_element (const Deque<T, A, S, O>& d){
+	return min_element(d, 0, d.size());}
+
+/**
+* carries the largest value so far into each segment's kernel, so the
+* segments see the same comparisons as one std::max_element scan (which
+* matters for NaN), then finds the first position holding that value
+* O(n), where n = last - first
+* M(1)
+* @param d a deque
+* @param first index of the first element to look at
+* @param last index one past the last element to look at
+* @return iterator to the first largest element in [first, last), or to last if the range is empty
+*/
+template <typename T, typename A, typename S, typename O>
+typename Deque<T, A, S, O>::const_iterator max_element (const Deque<T, A, S, O>& d, typename Deque<T, A, S, O>::size_type first, typename Deque<T, A, S, O>::size_type last){
+	typedef typename Deque<T, A, S, O>::size_type size_type;
+	if(first >= last)
+		return d.begin() + last;
+	T m = d[first];
+	size_type best = first;
+	size_type bestLength = d.segment_length(first);
+	if(bestLength > last - first) bestLength = last - first;
+	while(first < last){
+		size_type n = d.segment_length(first);
+		if(n > last - first) n = last - first;
+		T x = kernels::max(&d[first], n, m);
+		if(m < x){
+			m = x;
+			best = first;
+			bestLength = n;}
+		first += n;}
+	const T* p = &d[best];
+	return d.begin() + (best + (kernels::locate(p, bestLength, m) - p));}
+
+/**
+* O(n), where n is the size of d
+* M(1)
+* @param d a deque
+* @return iterator to the first largest element, or end() if d is empty
+*/
+template <typename T, typename A, typename S, typename O>
+typename Deque<T, A, S, O>::const_iterator max_element (const Deque<T, A, S, O>& d){
+	return max_element(d, 0, d.size());}
+
+} // deque
+} // prog
+} // dt
+
+#endif // DequeAlgorithm_h
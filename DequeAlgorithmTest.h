@@ -0,0 +1,148 @@
+// -------------------------------
+// prog/deque/DequeAlgorithmTest.h
+// Tj Wrenn
+// -------------------------------
+
+#ifndef DequeAlgorithmTest_h
+#define DequeAlgorithmTest_h
+
+// --------
+// includes
+// --------
+
+#include <algorithm> // find, count, min_element, max_element
+#include <cassert>   // assert
+#include <cmath>     // fabs
+#include <cstdlib>   // rand
+#include <limits>    // numeric_limits
+#include <numeric>   // accumulate
+
+#include "DequeAlgorithm.h"
+
+// ----------
+// namespaces
+// ----------
+
+namespace dt {
+namespace prog  {
+namespace deque  {
+
+// --------------------
+// deque_algorithm_test
+// --------------------
+
+/**
+ * function deque_algorithm_test is a tester of the segment-aware algorithms,
+ * instantiated with a Deque of an arithmetic type
+ */
+template <typename Deque>
+void deque_algorithm_test () {
+	typedef typename Deque::value_type value_type;
+	typedef typename Deque::size_type  size_type;
+
+	{
+	// empty deque
+	const Deque a;
+	assert(dt::prog::deque::find(a, 1) == a.end());
+	assert(dt::prog::deque::count(a, 1) == 0);
+	assert(dt::prog::deque::accumulate(a, (value_type)5) == 5);
+	assert(dt::prog::deque::min_element(a) == a.end());
+	assert(dt::prog::deque::max_element(a) == a.end());
+	}
+
+	{
+	// agree with the generic algorithms on every segment shape
+	std::srand(7);
+	for(int r = 0; r < 20; ++r){
+		Deque a;
+		int n = std::rand() % 2000;
+		int lead = std::rand() % 300;
+		for(int i = 0; i < lead; ++i)
+			a.push_front(0);
+		for(int i = 0; i < n; ++i)
+			a.push_back((value_type)(std::rand() % 50 - 25));
+		for(int i = 0; i < lead; ++i)
+			a.pop_front();
+		const Deque& c = a;
+
+		size_type first = n ? std::rand() % n : 0;
+		size_type last = first + (n ? std::rand() % (n - first + 1) : 0);
+		value_type v = (value_type)(std::rand() % 50 - 25);
+
+		assert(dt::prog::deque::find(c, v) == std::find(c.begin(), c.end(), v));
+		assert(dt::prog::deque::find(c, first, last, v) == std::find(c.begin() + first, c.begin() + last, v));
+		assert(dt::prog::deque::count(c, v) == std::count(c.begin(), c.end(), v));
+		assert(dt::prog::deque::count(c, first, last, v) == std::count(c.begin() + first, c.begin() + last, v));
+		assert(std::fabs((double)(dt::prog::deque::accumulate(c, (value_type)3) - std::accumulate(c.begin(), c.end(), (value_type)3))) < 1e-6);
+		assert(dt::prog::deque::min_element(c) == std::min_element(c.begin(), c.end()));
+		assert(dt::prog::deque::max_element(c) == std::max_element(c.begin(), c.end()));
+		assert(dt::prog::deque::min_element(c, first, last) == std::min_element(c.begin() + first, c.begin() + last));
+		assert(dt::prog::deque::max_element(c, first, last) == std::max_element(c.begin() + first, c.begin() + last));
+		}
+	}
+
+	{
+	// accumulate in the type of init, as std::accumulate does
+	Deque a;
+	for(int i = 0; i < 1000; ++i)
+		a.push_back((value_type)3000000);
+	assert(dt::prog::deque::accumulate(a, 0LL) == 3000000000LL);
+	assert(dt::prog::deque::accumulate(a, 2, 5, 0.5) == 9000000.5);
+	}
+
+	{
+	// kernels agree with the generic loops
+	value_type p[67];
+	for(int i = 0; i < 67; ++i)
+		p[i] = (value_type)((i * 37) % 23);
+	for(std::size_t n = 1; n <= 67; ++n){
+		assert(kernels::find(p, n, (value_type)5) == kernels::find<value_type>(p, n, 5));
+		assert(kernels::count(p, n, (value_type)5) == kernels::count<value_type>(p, n, 5));
+		assert(kernels::sum(p, n) == kernels::sum<value_type>(p, n));
+		assert(kernels::min(p, n, p[n / 2]) == kernels::min<value_type>(p, n, p[n / 2]));
+		assert(kernels::max(p, n, p[n / 2]) == kernels::max<value_type>(p, n, p[n / 2]));
+		}
+	}
+
+	if(std::numeric_limits<value_type>::has_quiet_NaN){
+	// a NaN anywhere, including the first element and inside a 4-lane group,
+	// gives the answer std::min_element and std::max_element give
+	const int at[] = {0, 1, 2, 3, 5, 63, 64, 130, 299};
+	for(int k = 0; k < 9; ++k){
+		Deque a;
+		for(int i = 0; i < 300; ++i)
+			a.push_back((value_type)((i * 37) % 101));
+		a[at[k]] = std::numeric_limits<value_type>::quiet_NaN();
+		const Deque& c = a;
+		assert(dt::prog::deque::min_element(c) == std::min_element(c.begin(), c.end()));
+		assert(dt::prog::deque::max_element(c) == std::max_element(c.begin(), c.end()));
+		assert(dt::prog::deque::min_element(c, 1, 200) == std::min_element(c.begin() + 1, c.begin() + 200));
+		assert(dt::prog::deque::max_element(c, 1, 200) == std::max_element(c.begin() + 1, c.begin() + 200));
+		}
+	// a NaN at the start of a later segment must not hide that segment's
+	// smallest and largest elements
+	for(int lead = 0; lead < 3; ++lead){
+		Deque a;
+		for(int i = 0; i < 200; ++i)
+			a.push_back(10);
+		for(int i = 0; i < lead; ++i)
+			a.pop_front();
+		size_type b = a.segment_length(0);
+		a[b] = std::numeric_limits<value_type>::quiet_NaN();
+		a[b + 5] = 1;
+		a[b + 6] = 99;
+		const Deque& c = a;
+		assert(dt::prog::deque::min_element(c) == c.begin() + (b + 5));
+		assert(dt::prog::deque::max_element(c) == c.begin() + (b + 6));
+		assert(dt::prog::deque::min_element(c) == std::min_element(c.begin(), c.end()));
+		assert(dt::prog::deque::max_element(c) == std::max_element(c.begin(), c.end()));
+		assert(dt::prog::deque::min_element(c, b, c.size()) == std::min_element(c.begin() + b, c.end()));
+		}
+	}
+} // deque_algorithm_test
+
+} // deque
+} // prog
+} // dt
+
+#endif // DequeAlgorithmTest_h
@@ -0,0 +1,507 @@
+// -----------------------
+// prog/deque/DequeBench.h
+// Tj Wrenn
+// -----------------------
+
+#ifndef DequeBench_h
+#define DequeBench_h
+
+// --------
+// includes
+// --------
+
+#include <algorithm> // find, count, min_element, max_element
+#include <chrono>    // steady_clock
+#include <cstdio>    // printf, sprintf
+#include <cstdlib>   // rand, srand
+#include <deque>     // deque
+#include <functional> // greater
+#include <numeric>   // accumulate
+#include <queue>     // priority_queue
+#include <utility>   // pair
+#include <vector>    // vector
+
+#include "DequeAlgorithm.h"
+#include "DequeParallel.h"
+#include "DequeSort.h"
+#include "GapDeque.h"
+#include "SlabAllocator.h"
+#include "SlidingWindowExtrema.h"
+#include "SortedDeque.h"
+#include "TieredVector.h"
+#include "TimeWindow.h"
+#include "TimerWheel.h"
+
+// ----------
+// namespaces
+// ----------
+
+namespace dt {
+namespace prog  {
+namespace deque  {
+
+// -----
+// bench
+// -----
+
+/**
+ * keeps the optimizer from discarding the work being timed
+ */
+template <typename T>
+void bench_sink (const T& v) {
+	static volatile char sink;
+	sink = sink + *reinterpret_cast<const volatile char*>(&v);}
+
+/**
+ * @param f work to time
+ * @param reps number of times to run f
+ * @return nanoseconds taken by the fastest run of f
+ */
+template <typename F>
+double bench_time (F f, int reps = 5) {
+	double best = 0;
+	for(int r = 0; r < reps; ++r){
+		std::chrono::steady_clock::time_point t0 = std::chrono::steady_clock::now();
+		f();
+		std::chrono::steady_clock::time_point t1 = std::chrono::steady_clock::now();
+		double ns = std::chrono::duration<double, std::nano>(t1 - t0).count();
+		if(r == 0 || ns < best)
+			best = ns;}
+	return best;}
+
+/**
+ * prints one result line
+ * @param group benchmark group
+ * @param name what was timed
+ * @param ns nanoseconds the run took
+ * @param ops number of operations in the run
+ */
+inline void bench_report (const char* group, const char* name, double ns, double ops) {
+	std::printf("%-24s %-36s %10.3f ns/op %10.1f Mop/s\n", group, name, ns / ops, ops * 1e3 / ns);}
+
+// ---------------
+// algorithm_bench
+// ---------------
+
+/**
+ * function algorithm_bench times the generic algorithms, which go through
+ * Deque's iterators, against the segment-aware ones in DequeAlgorithm.h
+ * @param group label for the element type
+ */
+template <typename Deque>
+void algorithm_bench (const char* group) {
+	typedef typename Deque::value_type value_type;
+	const int n = 4000000;
+
+	Deque a(n, -1);
+	a[n - 1] = 1;
+	const Deque& c = a;
+
+	bench_report(group, "std::find", bench_time([&] () { bench_sink(std::find(c.begin(), c.end(), (value_type)1)); }), n);
+	bench_report(group, "deque::find", bench_time([&] () { bench_sink(dt::prog::deque::find(c, (value_type)1)); }), n);
+	bench_report(group, "std::count", bench_time([&] () { bench_sink(std::count(c.begin(), c.end(), (value_type)-1)); }), n);
+	bench_report(group, "deque::count", bench_time([&] () { bench_sink(dt::prog::deque::count(c, (value_type)-1)); }), n);
+	bench_report(group, "std::accumulate", bench_time([&] () { bench_sink(std::accumulate(c.begin(), c.end(), (value_type)0)); }), n);
+	bench_report(group, "deque::accumulate", bench_time([&] () { bench_sink(dt::prog::deque::accumulate(c, (value_type)0)); }), n);
+	bench_report(group, "std::min_element", bench_time([&] () { bench_sink(*std::min_element(c.begin(), c.end())); }), n);
+	bench_report(group, "deque::min_element", bench_time([&] () { bench_sink(*dt::prog::deque::min_element(c)); }), n);
+	bench_report(group, "std::max_element", bench_time([&] () { bench_sink(*std::max_element(c.begin(), c.end())); }), n);
+	bench_report(group, "deque::max_element", bench_time([&] () { bench_sink(*dt::prog::deque::max_element(c)); }), n);
+} // algorithm_bench
+
+// ----------------
+// comparison_bench
+// ----------------
+
+/**
+ * function comparison_bench times == and < on equal deques whose blocks do
+ * not line up, against std::equal and std::lexicographical_compare
+ * @param group label for the element type
+ */
+template <typename Deque>
+void comparison_bench (const char* group) {
+	const int n = 4000000;
+
+	Deque a(n, -1);
+	Deque b;
+	for(int i = 0; i < 1000; ++i)
+		b.push_front(0);
+	for(int i = 0; i < n; ++i)
+		b.push_back(-1);
+	for(int i = 0; i < 1000; ++i)
+		b.pop_front();
+	const Deque& x = a;
+	const Deque& y = b;
+
+	bench_report(group, "std::equal", bench_time([&] () { bench_sink(std::equal(x.begin(), x.end(), y.begin())); }), n);
+	bench_report(group, "operator ==", bench_time([&] () { bench_sink(x == y); }), n);
+	bench_report(group, "std::lexicographical_compare", bench_time([&] () { bench_sink(std::lexicographical_compare(x.begin(), x.end(), y.begin(), y.end())); }), n);
+	bench_report(group, "operator <", bench_time([&] () { bench_sink(x < y); }), n);
+} // comparison_bench
+
+/**
+ * function parallel_bench times the parallel algorithms with execution::seq
+ * against execution::par
+ * @param group label for the element type
+ */
+template <typename Deque>
+void parallel_bench (const char* group) {
+	typedef typename Deque::value_type value_type;
+	namespace ex = dt::prog::deque::execution;
+	const int n = 8000000;
+
+	Deque a(n, 1);
+	Deque b(n, 0);
+
+	bench_report(group, "for_each seq", bench_time([&] () { dt::prog::deque::for_each(ex::seq, a, [] (value_type& v) { v = v * 3 + 1; }); }), n);
+	bench_report(group, "for_each par", bench_time([&] () { dt::prog::deque::for_each(ex::par, a, [] (value_type& v) { v = v * 3 + 1; }); }), n);
+	bench_report(group, "transform seq", bench_time([&] () { dt::prog::deque::transform(ex::seq, a, b, [] (value_type v) { return v / 3; }); }), n);
+	bench_report(group, "transform par", bench_time([&] () { dt::prog::deque::transform(ex::par, a, b, [] (value_type v) { return v / 3; }); }), n);
+	bench_report(group, "reduce seq", bench_time([&] () { bench_sink(dt::prog::deque::reduce(ex::seq, b)); }), n);
+	bench_report(group, "reduce par", bench_time([&] () { bench_sink(dt::prog::deque::reduce(ex::par, b)); }), n);
+	bench_report(group, "find_if seq", bench_time([&] () { bench_sink(dt::prog::deque::find_if(ex::seq, b, [] (value_type v) { return v < 0; })); }), n);
+	bench_report(group, "find_if par", bench_time([&] () { bench_sink(dt::prog::deque::find_if(ex::par, b, [] (value_type v) { return v < 0; })); }), n);
+} // parallel_bench
+
+/**
+ * function sort_bench times sort and stable_sort against std::sort through
+ * the iterators and std::sort on a vector holding the same elements
+ * @param group label for the element type
+ */
+template <typename Deque>
+void sort_bench (const char* group) {
+	typedef typename Deque::value_type value_type;
+	namespace ex = dt::prog::deque::execution;
+	const int n = 2000000;
+
+	Deque a;
+	std::srand(1);
+	for(int i = 0; i < n; ++i)
+		a.push_back((value_type)(std::rand() - RAND_MAX / 2));
+	std::vector<value_type> v(a.begin(), a.end());
+	Deque b;
+	std::vector<value_type> w;
+
+	bench_report(group, "std::sort vector", bench_time([&] () { w = v; std::sort(w.begin(), w.end()); }), n);
+	bench_report(group, "std::sort", bench_time([&] () { b = a; std::sort(b.begin(), b.end()); }), n);
+	bench_report(group, "deque::sort", bench_time([&] () { b = a; dt::prog::deque::sort(b); }), n);
+	bench_report(group, "deque::sort par", bench_time([&] () { b = a; dt::prog::deque::sort(ex::par, b); }), n);
+	bench_report(group, "deque::sort greater", bench_time([&] () { b = a; dt::prog::deque::sort(b, std::greater<value_type>()); }), n);
+	bench_report(group, "deque::stable_sort greater", bench_time([&] () { b = a; dt::prog::deque::stable_sort(b, std::greater<value_type>()); }), n);
+} // sort_bench
+
+/**
+ * function sorted_bench times lower_bound on a SortedDeque against
+ * std::lower_bound through Deque iterators and on a vector
+ * @param group label for the element type
+ */
+template <typename SortedDeque>
+void sorted_bench (const char* group) {
+	typedef typename SortedDeque::value_type value_type;
+	const int n = 16000000;
+	const int probes = 1000000;
+
+	SortedDeque a;
+	for(int i = 0; i < n; ++i)
+		a.push_back((value_type)i * 2);
+	const typename SortedDeque::deque_type& d = a.deque();
+	std::vector<value_type> v(d.begin(), d.end());
+	std::vector<value_type> keys;
+	std::srand(3);
+	for(int i = 0; i < probes; ++i)
+		keys.push_back((value_type)((std::rand() * 7919LL) % (2LL * n)));
+
+	bench_report(group, "std::lower_bound vector", bench_time([&] () { for(int i = 0; i < probes; ++i) bench_sink(*std::lower_bound(v.begin(), v.end(), keys[i])); }), probes);
+	bench_report(group, "std::lower_bound", bench_time([&] () { for(int i = 0; i < probes; ++i) bench_sink(*std::lower_bound(d.begin(), d.end(), keys[i])); }), probes);
+	bench_report(group, "SortedDeque::lower_bound", bench_time([&] () { for(int i = 0; i < probes; ++i) bench_sink(*a.lower_bound(keys[i])); }), probes);
+} // sorted_bench
+
+/**
+ * function tiered_bench times a mix of middle inserts, middle erases and
+ * lookups at random positions on TieredVector, Deque and std::vector
+ * @param group label for the element type
+ * @param n number of elements held
+ * @param lookups lookups per insert or erase
+ */
+template <typename T>
+void tiered_bench (const char* group, int n, int lookups) {
+	const int ops = 20000;
+	std::vector<unsigned> r;
+	std::srand(9);
+	for(int i = 0; i < ops * (lookups + 1); ++i)
+		r.push_back((unsigned)std::rand());
+
+	// each op inserts when even and erases when odd, so the size stays near n
+	TieredVector<T> t;
+	Deque<T> d;
+	std::vector<T> v;
+	for(int i = 0; i < n; ++i){
+		t.push_back((T)i);
+		d.push_back((T)i);
+		v.push_back((T)i);}
+
+	char name[64];
+	std::sprintf(name, "TieredVector %d lookups", lookups);
+	bench_report(group, name, bench_time([&] () {
+		const unsigned* p = &r[0];
+		for(int i = 0; i < ops; ++i){
+			if(i % 2) t.erase(*p++ % t.size());
+			else t.insert(*p++ % (t.size() + 1), (T)i);
+			for(int j = 0; j < lookups; ++j)
+				bench_sink(t[*p++ % t.size()]);}}, 1), ops);
+	std::sprintf(name, "Deque %d lookups", lookups);
+	bench_report(group, name, bench_time([&] () {
+		const unsigned* p = &r[0];
+		for(int i = 0; i < ops; ++i){
+			if(i % 2) d.erase(d.begin() + (*p++ % d.size()));
+			else d.insert(d.begin() + (*p++ % (d.size() + 1)), (T)i);
+			for(int j = 0; j < lookups; ++j)
+				bench_sink(d[*p++ % d.size()]);}}, 1), ops);
+	std::sprintf(name, "std::vector %d lookups", lookups);
+	bench_report(group, name, bench_time([&] () {
+		const unsigned* p = &r[0];
+		for(int i = 0; i < ops; ++i){
+			if(i % 2) v.erase(v.begin() + (*p++ % v.size()));
+			else v.insert(v.begin() + (*p++ % (v.size() + 1)), (T)i);
+			for(int j = 0; j < lookups; ++j)
+				bench_sink(v[*p++ % v.size()]);}}, 1), ops);
+} // tiered_bench
+
+/**
+ * function gap_bench times typing runs of characters at random positions of
+ * a text buffer, on a GapDeque and with Deque::insert
+ * @param group label for the buffer size
+ * @param n number of characters in the buffer
+ */
+inline void gap_bench (const char* group, int n) {
+	const int runs = 200;
+	const int run = 100;
+	std::vector<int> at;
+	std::srand(4);
+	for(int i = 0; i < runs; ++i)
+		at.push_back(std::rand() % n);
+
+	GapDeque<char> g;
+	Deque<char> d;
+	for(int i = 0; i < n; ++i){
+		g.push_back('a' + i % 26);
+		d.push_back('a' + i % 26);}
+
+	bench_report(group, "GapDeque::insert", bench_time([&] () {
+		for(int i = 0; i < runs; ++i){
+			g.set_cursor(at[i]);
+			for(int j = 0; j < run; ++j)
+				g.insert('x');}}, 1), runs * run);
+	bench_report(group, "Deque::insert", bench_time([&] () {
+		for(int i = 0; i < runs; ++i)
+			for(int j = 0; j < run; ++j)
+				d.insert(d.begin() + (at[i] + j), 'x');}, 1), runs * run);
+} // gap_bench
+
+/**
+ * function window_bench times a sliding-window minimum and maximum over a stream
+ * of random values, with SlidingWindowExtrema and with the same two monotonic
+ * queues kept in std::deque
+ * @param group label for the window size
+ * @param w number of values in the window
+ */
+inline void window_bench (const char* group, int w) {
+	const int n = 1 << 20;
+	std::vector<int> v(n);
+	std::vector<int> mins(n);
+	std::vector<int> maxs(n);
+	std::srand(6);
+	for(int i = 0; i < n; ++i)
+		v[i] = std::rand();
+
+	SlidingWindowExtrema<int> a(w);
+	bench_report(group, "SlidingWindowExtrema::push", bench_time([&] () {
+		for(int i = 0; i < n; ++i){
+			a.push(v[i]);
+			bench_sink(a.min() ^ a.max());}}), n);
+	bench_report(group, "SlidingWindowExtrema::push_n", bench_time([&] () {
+		a.push_n(&v[0], n, &mins[0], &maxs[0]);}), n);
+
+	typedef std::pair<long long, int> entry;
+	std::deque<entry> lows;
+	std::deque<entry> highs;
+	long long next = 0;
+	bench_report(group, "std::deque", bench_time([&] () {
+		for(int i = 0; i < n; ++i, ++next){
+			while(!lows.empty() && lows.back().second >= v[i]) lows.pop_back();
+			lows.push_back(entry(next, v[i]));
+			while(!highs.empty() && highs.back().second <= v[i]) highs.pop_back();
+			highs.push_back(entry(next, v[i]));
+			if(lows.front().first <= next - w) lows.pop_front();
+			if(highs.front().first <= next - w) highs.pop_front();
+			bench_sink(lows.front().second ^ highs.front().second);}}), n);
+} // window_bench
+
+/**
+ * function time_window_bench times expiring records in batches, with
+ * TimeWindow::expire_before and with a loop of front() checks and pop_front()
+ * on a Deque
+ * @param group label for the batch size
+ * @param batch number of records pushed between expiries
+ */
+inline void time_window_bench (const char* group, int batch) {
+	const int n = 1 << 20;
+	const long long span = 1 << 16;
+
+	TimeWindow<double> a;
+	bench_report(group, "TimeWindow::expire_before", bench_time([&] () {
+		for(long long t = 0; t < n; ){
+			for(int j = 0; j < batch; ++j, ++t)
+				a.push(t, (double)t);
+			bench_sink(a.expire_before(t - span));}
+		a.clear();}), n);
+
+	typedef TimeWindow<double>::Record record;
+	Deque<record> d;
+	double sum = 0;
+	bench_report(group, "Deque::pop_front", bench_time([&] () {
+		for(long long t = 0; t < n; ){
+			for(int j = 0; j < batch; ++j, ++t){
+				d.push_back(record(t, (double)t));
+				sum += t;}
+			while(!d.empty() && d.front().time < t - span){
+				sum -= d.front().value;
+				d.pop_front();}
+			bench_sink(sum);}
+		d.clear();}), n);
+} // time_window_bench
+
+/**
+ * function timer_bench times n timers with random delays, a tenth of them
+ * cancelled, run to completion, on a TimerWheel and on a binary heap that
+ * skips cancelled timers when they reach the top
+ * @param group label for the number of timers
+ * @param n number of timers
+ */
+inline void timer_bench (const char* group, int n) {
+	std::vector<unsigned> delay(n);
+	std::srand(8);
+	for(int i = 0; i < n; ++i)
+		delay[i] = 1 + std::rand() % 100000;
+
+	bench_report(group, "TimerWheel", bench_time([&] () {
+		TimerWheel<int> w;
+		std::vector<TimerWheel<int>::timer_id> ids(n);
+		for(int i = 0; i < n; ++i)
+			ids[i] = w.schedule(w.now() + delay[i], i);
+		for(int i = 0; i < n; i += 10)
+			w.cancel(ids[i]);
+		TimerWheel<int>::deque_type out(w.allocator());
+		while(!w.empty()){
+			w.advance(w.now() + 64, out);
+			bench_sink(out.size());
+			out.clear();}}, 3), n);
+
+	typedef std::pair<unsigned long long, int> entry;
+	bench_report(group, "std::priority_queue", bench_time([&] () {
+		std::priority_queue<entry, std::vector<entry>, std::greater<entry> > q;
+		std::vector<char> cancelled(n);
+		for(int i = 0; i < n; ++i)
+			q.push(entry(delay[i], i));
+		for(int i = 0; i < n; i += 10)
+			cancelled[i] = 1;
+		while(!q.empty()){
+			if(!cancelled[q.top().second])
+				bench_sink(q.top().first);
+			q.pop();}}, 3), n);
+} // timer_bench
+
+// -------------
+// latency_bench
+// -------------
+
+/**
+ * function latency_bench times every one of n push_backs onto an empty
+ * container on its own and prints the 50th, 99th and 99.9th percentiles and
+ * the maximum, which is where a growth step that does all its work in one
+ * push shows up.  Deque spreads the copy of its outer array over the pushes
+ * before the switch, migrate_step slots each, so its maximum is a block
+ * allocation rather than the copy.  the clock's own overhead is in every sample
+ * @param group label for the container
+ * @param n number of pushes
+ */
+template <typename C>
+void latency_bench (const char* group, int n) {
+	typedef std::chrono::steady_clock clock;
+	std::vector<double> ns(n);
+	for(int r = 0; r < 3; ++r){
+		C c;
+		for(int i = 0; i < n; ++i){
+			clock::time_point t0 = clock::now();
+			c.push_back(i);
+			clock::time_point t1 = clock::now();
+			double x = std::chrono::duration<double, std::nano>(t1 - t0).count();
+			if(r == 0 || x < ns[i])
+				ns[i] = x;}
+		bench_sink(c.size());}
+	std::sort(ns.begin(), ns.end());
+	std::printf("%-24s %-36s p50 %8.0f  p99 %8.0f  p99.9 %8.0f  max %10.0f ns\n", group, "push_back latency",
+		ns[n / 2], ns[(size_t)(n * 0.99)], ns[(size_t)(n * 0.999)], ns[n - 1]);
+} // latency_bench
+
+/**
+ * function slab_bench times building a Deque<int> of n elements with
+ * push_back and destroying it, with each block from the heap and with the
+ * blocks carved from the slabs of a SlabCache
+ * @param group label for the number of elements
+ * @param n number of elements
+ */
+inline void slab_bench (const char* group, int n) {
+	bench_report(group, "Deque push_back, heap blocks", bench_time([&] () {
+		Deque<int> d;
+		for(int i = 0; i < n; ++i)
+			d.push_back(i);
+		bench_sink(d.size());}), n);
+	bench_report(group, "Deque push_back, slab blocks", bench_time([&] () {
+		SlabCache slabs;
+		SlabAllocator<int> a(&slabs);
+		Deque<int, SlabAllocator<int> > d(a);
+		for(int i = 0; i < n; ++i)
+			d.push_back(i);
+		bench_sink(d.size());}), n);
+} // slab_bench
+
+/**
+ * function drain_bench times a consumer emptying a Deque<int> of n elements:
+ * front() and pop_front() one at a time, pop_front_n() into a buffer of 256,
+ * and drain()
+ * @param group label for the number of elements
+ * @param n number of elements
+ */
+inline void drain_bench (const char* group, int n) {
+	Deque<int> d;
+	std::vector<int> buffer(256);
+	bench_report(group, "Deque front, pop_front", bench_time([&] () {
+		d.resize(n, 1);
+		long long x = 0;
+		while(!d.empty()){
+			x += d.front();
+			d.pop_front();}
+		bench_sink(x);}), n);
+	bench_report(group, "Deque pop_front_n", bench_time([&] () {
+		d.resize(n, 1);
+		long long x = 0;
+		while(!d.empty()){
+			int* e = d.pop_front_n(buffer.size(), buffer.data());
+			for(int* p = buffer.data(); p != e; ++p)
+				x += *p;}
+		bench_sink(x);}), n);
+	bench_report(group, "Deque drain", bench_time([&] () {
+		d.resize(n, 1);
+		long long x = 0;
+		d.drain([&] (int* p, std::size_t k) {
+			for(std::size_t j = 0; j < k; ++j)
+				x += p[j];});
+		bench_sink(x);}), n);
+} // drain_bench
+
+} // deque
+} // prog
+} // dt
+
+#endif // DequeBench_h
@@ -0,0 +1,191 @@
+// --------------------------
+// prog/deque/DequeObserver.h
+// Tj Wrenn
+// --------------------------
+
+#ifndef DequeObserver_h
+#define DequeObserver_h
+
+// --------
+// includes
+// --------
+
+#include <chrono>  // steady_clock
+#include <cstddef> // size_t
+#include <cstdint> // uint64_t
+
+#if defined(__linux__) && defined(__has_include)
+#if __has_include(<sys/sdt.h>)
+#include <sys/sdt.h> // STAP_PROBE4
+#define DT_DEQUE_SDT 1
+#endif
+#endif
+
+#ifndef DT_DEQUE_SDT
+#define DT_DEQUE_SDT 0
+#endif
+
+// ----------
+// namespaces
+// ----------
+
+namespace dt{
+namespace prog{
+namespace deque{
+
+// ----------
+// DequeEvent
+// ----------
+
+/**
+* What a Deque tells its observer: the kind of event, the capacity before and
+* after it, in elements, a count that depends on the kind, and how long the
+* event took.
+*
+* grow:            the outer array was replaced by a larger one, by ensureCapacity() or
+*                  at the end of a migration; count is its new size
+* recenter:        the outer array was rotated, in place or by a migration; count is its size
+* block_allocated: a block was allocated; count is its size in bytes
+* block_freed:     a block was freed; count is its size in bytes
+* shift:           an insert or erase in the middle moved count elements
+*/
+struct DequeEvent{
+	enum kind_type {grow, recenter, block_allocated, block_freed, shift};
+
+	kind_type kind;
+	std::size_t old_capacity;
+	std::size_t new_capacity;
+	std::size_t count;
+	std::uint64_t nanoseconds;};
+
+/**
+* @return steady clock time in nanoseconds, for timing events
+*/
+inline std::uint64_t deque_clock (){
+	return (std::uint64_t)std::chrono::duration_cast<std::chrono::nanoseconds>(std::chrono::steady_clock::now().time_since_epoch()).count();}
+
+// ----------
+// NoObserver
+// ----------
+
+/**
+* The default observer policy of Deque.  An observer provides:
+*
+* enabled:     false to have Deque skip the clock reads and the calls altogether
+* large_shift: the fewest elements moved in the middle that make a shift event
+* observe():   called after each event
+*
+* Deque holds its observer as an empty base, as it does its statistics, and
+* hands it out through observer().
+*/
+struct NoObserver{
+	static const bool enabled = false;
+	static const std::size_t large_shift = 0;
+
+	void observe (const DequeEvent&){}};
+
+// ----------
+// RingTracer
+// ----------
+
+/**
+* An observer keeping the last N events in a ring inside the Deque, to be
+* read back when a latency outlier needs explaining.  Shifts of fewer than
+* LargeShift elements are not recorded.
+*/
+template <std::size_t N = 256, std::size_t LargeShift = 1024>
+class RingTracer{
+public:
+	typedef std::size_t size_type;
+
+	static const bool enabled = true;
+	static const size_type large_shift = LargeShift;
+
+private:
+	DequeEvent ring[N];
+
+	/**
+	* number of events observed, including those overwritten
+	*/
+	unsigned long long n;
+
+public:
+	RingTracer ()
+		: n(0) {}
+
+	void observe (const DequeEvent& e){
+		ring[n++ % N] = e;}
+
+	/**
+	* O(1)
+	* M(1)
+	* @return number of events held, at most N
+	*/
+	size_type size ()const {
+		return (n < N) ? (size_type)n : N;}
+
+	/**
+	* O(1)
+	* M(1)
+	* @return number of events observed since construction or clear()
+	*/
+	unsigned long long total ()const {
+		return n;}
+
+	/**
+	* O(1)
+	* M(1)
+	* @param i index of an event held, 0 being the oldest
+	* @return the event
+	*/
+	const DequeEvent& operator [] (size_type i)const {
+		return ring[(n - size() + i) % N];}
+
+	void clear (){
+		n = 0;}};
+
+// ------------
+// UsdtObserver
+// ------------
+
+/**
+* An observer firing a USDT static probe per event, provider dt_deque, probe
+* named after the kind, with arguments old capacity, new capacity, count and
+* nanoseconds, e.g. for bpftrace:
+*
+*     usdt:./bench:dt_deque:grow { @[arg3] = hist(arg3); }
+*
+* Without <sys/sdt.h> it is disabled and costs nothing.
+*/
+struct UsdtObserver{
+	static const bool enabled = DT_DEQUE_SDT;
+	static const std::size_t large_shift = 1024;
+
+	void observe (const DequeEvent& e){
+#if DT_DEQUE_SDT
+		switch(e.kind){
+			case DequeEvent::grow:
+				STAP_PROBE4(dt_deque, grow, e.old_capacity, e.new_capacity, e.count, e.nanoseconds);
+				break;
+			case DequeEvent::recenter:
+				STAP_PROBE4(dt_deque, recenter, e.old_capacity, e.new_capacity, e.count, e.nanoseconds);
+				break;
+			case DequeEvent::block_allocated:
+				STAP_PROBE4(dt_deque, block_allocated, e.old_capacity, e.new_capacity, e.count, e.nanoseconds);
+				break;
+			case DequeEvent::block_freed:
+				STAP_PROBE4(dt_deque, block_freed, e.old_capacity, e.new_capacity, e.count, e.nanoseconds);
+				break;
+			case DequeEvent::shift:
+				STAP_PROBE4(dt_deque, shift, e.old_capacity, e.new_capacity, e.count, e.nanoseconds);
+				break;}
+#else
+		(void)e;
+#endif
+	}};
+
+} // deque
+} // prog
+} // dt
+
+#endif // DequeObserver_h
@@ -0,0 +1,107 @@
+// ------------------------------
+// prog/deque/DequeObserverTest.h
+// Tj Wrenn
+// ------------------------------
+
+#ifndef DequeObserverTest_h
+#define DequeObserverTest_h
+
+// --------
+// includes
+// --------
+
+#include <cassert> // assert
+
+#include "DequeObserver.h"
+
+// ----------
+// namespaces
+// ----------
+
+namespace dt {
+namespace prog  {
+namespace deque  {
+
+// -------------------
+// deque_observer_test
+// -------------------
+
+/**
+ * function deque_observer_test is a tester of Deque's observer hooks,
+ * instantiated with an integral type and a RingTracer holding at least
+ * 64 events and recording shifts of 8 elements or more
+ */
+template <typename Deque>
+void deque_observer_test () {
+	typedef typename Deque::value_type    value_type;
+	typedef typename Deque::size_type     size_type;
+	typedef typename Deque::observer_type observer_type;
+
+	{
+	Deque x;
+	const observer_type& o = x.observer();
+	assert(o.size() == 1);
+	assert(o[0].kind == DequeEvent::block_allocated);
+	assert(o[0].count > 0);
+	}
+
+	{
+	Deque x;
+	x.observer().clear();
+	for(int i = 0; i < 2000; ++i)
+		x.push_back(value_type(i));
+	const observer_type& o = x.observer();
+	size_type grows = 0;
+	size_type blocks = 0;
+	size_type capacity = 0;
+	for(size_type i = 0; i < o.size(); ++i){
+		const DequeEvent& e = o[i];
+		if(e.kind == DequeEvent::grow){
+			assert(e.old_capacity < e.new_capacity);
+			assert(e.new_capacity >= 2 * e.old_capacity);
+			assert(e.old_capacity >= capacity);
+			capacity = e.new_capacity;
+			++grows;}
+		else if(e.kind == DequeEvent::block_allocated)
+			++blocks;}
+	assert(grows > 0);
+	assert(blocks > 0);
+	assert(o.total() == o.size());
+	}
+
+	{
+	Deque x;
+	for(int i = 0; i < 100; ++i)
+		x.push_back(value_type(i));
+	x.observer().clear();
+	x.insert(x.begin() + 3, value_type(-1));
+	assert(x.observer().total() == 0);
+	x.insert(x.begin() + 20, value_type(-1));
+	assert(x.observer().total() == 1);
+	assert(x.observer()[0].kind == DequeEvent::shift);
+	assert(x.observer()[0].count == 20);
+	x.erase(x.begin() + 90);
+	assert(x.observer().total() == 2);
+	assert(x.observer()[1].count == 11);
+	x.erase(x.begin() + 40, x.begin() + 50);
+	assert(x.observer().total() == 3);
+	assert(x.observer()[2].count == 40);
+	}
+
+	{
+	Deque x;
+	x.observer().clear();
+	for(int i = 0; i < 100000; ++i)
+		x.push_front(value_type(i));
+	const observer_type& o = x.observer();
+	assert(o.total() > o.size());
+	for(size_type i = 1; i < o.size(); ++i)
+		assert(o[i - 1].new_capacity <= o[i].old_capacity);
+	}
+} // deque_observer_test
+
+} // deque
+} // prog
+} // dt
+
+#endif // DequeObserverTest_h
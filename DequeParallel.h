@@ -0,0 +1,458 @@
+// --------------------------
+// prog/deque/DequeParallel.h
+// Tj Wrenn
+// --------------------------
+
+#ifndef DequeParallel_h
+#define DequeParallel_h
+
+// --------
+// includes
+// --------
+
+#include <algorithm> // fill_n, sort
+#include <atomic> // atomic
+#include <condition_variable> // condition_variable
+#include <cstddef> // size_t
+#include <exception> // terminate
+#include <functional> // function, plus
+#include <mutex> // mutex, unique_lock
+#include <thread> // thread
+#include <utility> // pair
+#include <vector> // vector
+
+#include "Deque.h"
+
+// ----------
+// namespaces
+// ----------
+
+namespace dt{
+namespace prog{
+namespace deque{
+
+// ----------
+// ThreadPool
+// ----------
+
+/**
+* A fixed set of worker threads that run fork-join jobs: run() hands out task
+* indices to the workers and to the calling thread, and returns once every
+* task has finished.  Jobs from different threads are run one after another;
+* a task must not call run() on the pool it is running on.  A task that throws
+* ends the program, on whichever thread it runs, as under std::execution::par;
+* letting it unwind run() would leave workers running the caller's dead job.
+*/
+class ThreadPool{
+private:
+// ----
+// data
+// ----
+
+std::vector<std::thread> workers;
+std::mutex m;
+std::mutex serial;
+std::condition_variable wake;
+std::condition_variable done;
+const std::function<void(std::size_t)>* job;
+std::size_t tasks;
+std::size_t next;
+std::size_t remaining;
+unsigned generation;
+bool stop;
+
+/**
+* runs tasks of the current job until none are left
+* @param lock a lock on m, held on entry and on return
+*/
+void work (std::unique_lock<std::mutex>& lock){
+	while(next < tasks){
+		std::size_t i = next++;
+		const std::function<void(std::size_t)>* fn = job;
+		lock.unlock();
+		try {
+			(*fn)(i);
+		} catch (...) {
+			std::terminate();}
+		lock.lock();
+		if(--remaining == 0)
+			done.notify_all();}}
+
+/**
+* body of every worker thread
+*/
+void loop (){
+	std::unique_lock<std::mutex> lock(m);
+	unsigned seen = generation;
+	for(;;){
+		wake.wait(lock, [this, &seen] () { return stop || generation != seen; });
+		if(stop)
+			return;
+		seen = generation;
+		work(lock);}}
+
+ThreadPool (const ThreadPool&);
+ThreadPool& operator = (const ThreadPool&);
+
+public:
+// ----------
+// ThreadPool
+// ----------
+
+/**
+* @param n number of worker threads; the thread calling run() works too
+*/
+explicit ThreadPool (unsigned n)
+	: job(NULL), tasks(0), next(0), remaining(0), generation(0), stop(false) {
+		for(unsigned i = 0; i < n; ++i)
+			workers.push_back(std::thread(&ThreadPool::loop, this));}
+
+~ThreadPool (){
+	{
+	std::lock_guard<std::mutex> lock(m);
+	stop = true;
+	}
+	wake.notify_all();
+	for(std::size_t i = 0; i < workers.size(); ++i)
+		workers[i].join();}
+
+/**
+* @return number of threads that work on a job, counting the caller
+*/
+unsigned size ()const {
+	return (unsigned)workers.size() + 1;}
+
+/**
+* calls fn(i) for every i in [0, n), spread over the pool, and waits for all of them
+* @param n number of tasks
+* @param fn task body
+*/
+void run (std::size_t n, const std::function<void(std::size_t)>& fn){
+	if(n == 0)
+		return;
+	std::lock_guard<std::mutex> one(serial);
+	std::unique_lock<std::mutex> lock(m);
+	job = &fn;
+	tasks = n;
+	next = 0;
+	remaining = n;
+	++generation;
+	wake.notify_all();
+	work(lock);
+	done.wait(lock, [this] () { return remaining == 0; });
+	job = NULL;}};
+
+/**
+* @return the pool used by execution::par, with one thread per hardware thread
+*/
+inline ThreadPool& default_thread_pool (){
+	static ThreadPool pool(std::thread::hardware_concurrency() > 1 ? std::thread::hardware_concurrency() - 1 : 0);
+	return pool;}
+
+// ---------
+// execution
+// ---------
+
+/**
+* execution policies in the style of std::execution: seq runs on the calling
+* thread, par splits the range at block boundaries and runs the pieces on a
+* ThreadPool, so no two threads ever write to the same block
+*/
+namespace execution{
+
+struct sequenced_policy{};
+
+struct parallel_policy{
+	ThreadPool* pool;
+
+	/**
+	* @param pool pool to run on, or NULL for default_thread_pool()
+	*/
+	explicit parallel_policy (ThreadPool* pool = NULL)
+		: pool(pool) {}
+
+	ThreadPool& threads ()const {
+		return (pool != NULL) ? *pool : default_thread_pool();}};
+
+static const sequenced_policy seq = sequenced_policy();
+static const parallel_policy par = parallel_policy();
+
+} // execution
+
+// -------
+// details
+// -------
+
+namespace parallel{
+
+/**
+* smallest piece worth handing to another thread
+*/
+static const std::size_t grain = 16384;
+
+/**
+* cuts [first, last) of d into about parts pieces, moving every inner cut
+* forward to the start of a block
+* @param d a deque
+* @param first index of the first element
+* @param last index one past the last element
+* @param parts number of pieces wanted
+* @return the cuts, starting with first and ending with last
+*/
+template <typename T, typename A, typename S, typename O>
+std::vector<typename Deque<T, A, S, O>::size_type> split (const Deque<T, A, S, O>& d, typename Deque<T, A, S, O>::size_type first, typename Deque<T, A, S, O>::size_type last, std::size_t parts){
+	typedef typename Deque<T, A, S, O>::size_type size_type;
+	std::vector<size_type> cuts(1, first);
+	size_type n = last - first;
+	if(parts > n / grain + 1)
+		parts = n / grain + 1;
+	size_type step = (n + parts - 1) / (parts ? parts : 1);
+	size_type i = first;
+	while(i < last){
+		size_type j = (last - i > step) ? i + step : last;
+		if(j < last){
+			j += d.segment_length(j);
+			if(j > last) j = last;}
+		cuts.push_back(j);
+		i = j;}
+	return cuts;}
+
+/**
+* calls fn(first, last) for every piece of [first, last) of d, using policy
+*/
+template <typename T, typename A, typename S, typename O, typename F>
+void run (const execution::sequenced_policy&, const Deque<T, A, S, O>&, typename Deque<T, A, S, O>::size_type first, typename Deque<T, A, S, O>::size_type last, F fn){
+	if(first < last)
+		fn(first, last);}
+
+template <typename T, typename A, typename S, typename O, typename F>
+void run (const execution::parallel_policy& policy, const Deque<T, A, S, O>& d, typename Deque<T, A, S, O>::size_type first, typename Deque<T, A, S, O>::size_type last, F fn){
+	typedef typename Deque<T, A, S, O>::size_type size_type;
+	ThreadPool& pool = policy.threads();
+	std::vector<size_type> cuts = split(d, first, last, pool.size() * 4);
+	if(cuts.size() <= 2){
+		if(first < last){
+			try {
+				fn(first, last);
+			} catch (...) {
+				std::terminate();}}
+		return;}
+	pool.run(cuts.size() - 1, [&cuts, &fn] (std::size_t i) { fn(cuts[i], cuts[i + 1]); });}
+
+} // parallel
+
+// --------
+// for_each
+// --------
+
+/**
+* calls f on every element of [first, last) of d
+* O(n), where n = last - first, divided over the threads
+* M(1)
+* @param policy execution::seq or execution::par
+* @param d a deque
+* @param first index of the first element
+* @param last index one past the last element
+* @param f function called with a reference to each element
+*/
+template <typename Policy, typename T, typename A, typename S, typename O, typename F>
+void for_each (const Policy& policy, Deque<T, A, S, O>& d, typename Deque<T, A, S, O>::size_type first, typename Deque<T, A, S, O>::size_type last, F f){
+	typedef typename Deque<T, A, S, O>::size_type size_type;
+	parallel::run(policy, d, first, last, [&d, &f] (size_type i, size_type e) {
+		while(i < e){
+			size_type n = d.segment_length(i);
+			if(n > e - i) n = e - i;
+			T* p = &d[i];
+			for(size_type j = 0; j < n; ++j)
+				f(p[j]);
+			i += n;}});}
+
+template <typename Policy, typename T, typename A, typename S, typename O, typename F>
+void for_each (const Policy& policy, Deque<T, A, S, O>& d, F f){
+	for_each(policy, d, 0, d.size(), f);}
+
+// ----
+// fill
+// ----
+
+/**
+* assigns v to every element of [first, last) of d
+* O(n), where n = last - first, divided over the threads
+* M(1)
+* @param policy execution::seq or execution::par
+* @param d a deque
+* @param first index of the first element
+* @param last index one past the last element
+* @param v value to assign
+*/
+template <typename Policy, typename T, typename A, typename S, typename O>
+void fill (const Policy& policy, Deque<T, A, S, O>& d, typename Deque<T, A, S, O>::size_type first, typename Deque<T, A, S, O>::size_type last, const typename Deque<T, A, S, O>::value_type& v){
+	typedef typename Deque<T, A, S, O>::size_type size_type;
+	parallel::run(policy, d, first, last, [&d, &v] (size_type i, size_type e) {
+		while(i < e){
+			size_type n = d.segment_length(i);
+			if(n > e - i) n = e - i;
+			std::fill_n(&d[i], n, v);
+			i += n;}});}
+
+template <typename Policy, typename T, typename A, typename S, typename O>
+void fill (const Policy& policy, Deque<T, A, S, O>& d, const typename Deque<T, A, S, O>::value_type& v){
+	fill(policy, d, 0, d.size(), v);}
+
+// ---------
+// transform
+// ---------
+
+/**
+* assigns op(in[first + i]) to out[out_first + i] for every i in [0, last - first).
+* the work is cut at out's block boundaries, since out is the deque written to.
+* O(n), where n = last - first, divided over the threads
+* M(1)
+* @param policy execution::seq or execution::par
+* @param in deque read from
+* @param first index of the first element of in
+* @param last index one past the last element of in
+* @param out deque written to, with room for last - first elements from out_first on
+* @param out_first index of the first element of out written to
+* @param op function applied to each element of in
+*/
+template <typename Policy, typename T, typename A, typename S, typename O, typename U, typename B, typename SB, typename OB, typename F>
+void transform (const Policy& policy, const Deque<T, A, S, O>& in, typename Deque<T, A, S, O>::size_type first, typename Deque<T, A, S, O>::size_type last, Deque<U, B, SB, OB>& out, typename Deque<U, B, SB, OB>::size_type out_first, F op){
+	typedef typename Deque<U, B, SB, OB>::size_type size_type;
+	size_type shift = first - out_first;
+	parallel::run(policy, out, out_first, out_first + (last - first), [&in, &out, &op, shift] (size_type i, size_type e) {
+		while(i < e){
+			size_type n = out.segment_length(i);
+			if(in.segment_length(i + shift) < n) n = in.segment_length(i + shift);
+			if(n > e - i) n = e - i;
+			const T* p = &in[i + shift];
+			U* q = &out[i];
+			for(size_type j = 0; j < n; ++j)
+				q[j] = op(p[j]);
+			i += n;}});}
+
+/**
+* O(n), where n is the size of in, divided over the threads
+* M(1)
+* @param policy execution::seq or execution::par
+* @param in deque read from
+* @param out deque written to, at least as large as in
+* @param op function applied to each element of in
+*/
+template <typename Policy, typename T, typename A, typename S, typename O, typename U, typename B, typename SB, typename OB, typename F>
+void transform (const Policy& policy, const Deque<T, A, S, O>& in, Deque<U, B, SB, OB>& out, F op){
+	transform(policy, in, 0, in.size(), out, 0, op);}
+
+// ----
+// copy
+// ----
+
+/**
+* O(n), where n = last - first, divided over the threads
+* M(1)
+* @param policy execution::seq or execution::par
+* @param in deque read from
+* @param first index of the first element of in
+* @param last index one past the last element of in
+* @param out deque written to, with room for last - first elements from out_first on
+* @param out_first index of the first element of out written to
+*/
+template <typename Policy, typename T, typename A, typename S, typename O, typename B, typename SB, typename OB>
+void copy (const Policy& policy, const Deque<T, A, S, O>& in, typename Deque<T, A, S, O>::size_type first, typename Deque<T, A, S, O>::size_type last, Deque<T, B, SB, OB>& out, typename Deque<T, B, SB, OB>::size_type out_first){
+	transform(policy, in, first, last, out, out_first, [] (const T& v) -> const T& { return v; });}
+
+template <typename Policy, typename T, typename A, typename S, typename O, typename B, typename SB, typename OB>
+void copy (const Policy& policy, const Deque<T, A, S, O>& in, Deque<T, B, SB, OB>& out){
+	copy(policy, in, 0, in.size(), out, 0);}
+
+// ------
+// reduce
+// ------
+
+/**
+* combines init and the elements of [first, last) of d with op, which must be
+* associative: each piece is reduced on its own, then the pieces are combined
+* in order, as std::reduce may do
+* O(n), where n = last - first, divided over the threads
+* M(p), where p is the number of pieces
+* @param policy execution::seq or execution::par
+* @param d a deque
+* @param first index of the first element
+* @param last index one past the last element
+* @param init initial value
+* @param op associative binary operation
+* @return init combined with every element
+*/
+template <typename Policy, typename T, typename A, typename S, typename O, typename U, typename F>
+U reduce (const Policy& policy, const Deque<T, A, S, O>& d, typename Deque<T, A, S, O>::size_type first, typename Deque<T, A, S, O>::size_type last, U init, F op){
+	typedef typename Deque<T, A, S, O>::size_type size_type;
+	std::mutex m;
+	std::vector<std::pair<size_type, U> > parts;
+	parallel::run(policy, d, first, last, [&d, &op, &m, &parts] (size_type i, size_type e) {
+		size_type b = i;
+		U r = d[i++];
+		while(i < e){
+			size_type n = d.segment_length(i);
+			if(n > e - i) n = e - i;
+			const T* p = &d[i];
+			for(size_type j = 0; j < n; ++j)
+				r = op(r, p[j]);
+			i += n;}
+		std::lock_guard<std::mutex> lock(m);
+		parts.push_back(std::make_pair(b, r));});
+	std::sort(parts.begin(), parts.end(), [] (const std::pair<size_type, U>& x, const std::pair<size_type, U>& y) { return x.first < y.first; });
+	for(std::size_t i = 0; i < parts.size(); ++i)
+		init = op(init, parts[i].second);
+	return init;}
+
+template <typename Policy, typename T, typename A, typename S, typename O, typename U, typename F>
+U reduce (const Policy& policy, const Deque<T, A, S, O>& d, U init, F op){
+	return reduce(policy, d, 0, d.size(), init, op);}
+
+template <typename Policy, typename T, typename A, typename S, typename O>
+T reduce (const Policy& policy, const Deque<T, A, S, O>& d){
+	return reduce(policy, d, 0, d.size(), T(), std::plus<T>());}
+
+// -------
+// find_if
+// -------
+
+/**
+* finds the first element of [first, last) of d that satisfies pred.  pieces
+* past a match that has already been found are skipped or abandoned.
+* O(n), where n = last - first, divided over the threads
+* M(1)
+* @param policy execution::seq or execution::par
+* @param d a deque
+* @param first index of the first element
+* @param last index one past the last element
+* @param pred predicate
+* @return iterator to the first element satisfying pred, or to last
+*/
+template <typename Policy, typename T, typename A, typename S, typename O, typename P>
+typename Deque<T, A, S, O>::const_iterator find_if (const Policy& policy, const Deque<T, A, S, O>& d, typename Deque<T, A, S, O>::size_type first, typename Deque<T, A, S, O>::size_type last, P pred){
+	typedef typename Deque<T, A, S, O>::size_type size_type;
+	std::atomic<size_type> found(last);
+	parallel::run(policy, d, first, last, [&d, &pred, &found] (size_type i, size_type e) {
+		while(i < e && i < found.load(std::memory_order_relaxed)){
+			size_type n = d.segment_length(i);
+			if(n > e - i) n = e - i;
+			const T* p = &d[i];
+			for(size_type j = 0; j < n; ++j)
+				if(pred(p[j])){
+					size_type k = i + j;
+					size_type cur = found.load(std::memory_order_relaxed);
+					while(k < cur && !found.compare_exchange_weak(cur, k)) {}
+					return;}
+			i += n;}});
+	return d.begin() + found.load();}
+
+template <typename Policy, typename T, typename A, typename S, typename O, typename P>
+typename Deque<T, A, S, O>::const_iterator find_if (const Policy& policy, const Deque<T, A, S, O>& d, P pred){
+	return find_if(policy, d, 0, d.size(), pred);}
+
+} // deque
+} // prog
+} // dt
+
+#endif // DequeParallel_h
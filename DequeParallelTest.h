@@ -0,0 +1,123 @@
+// ------------------------------
+// prog/deque/DequeParallelTest.h
+// Tj Wrenn
+// ------------------------------
+
+#ifndef DequeParallelTest_h
+#define DequeParallelTest_h
+
+// --------
+// includes
+// --------
+
+#include <atomic>     // atomic
+#include <cassert>    // assert
+#include <functional> // plus
+
+#include "DequeParallel.h"
+
+// ----------
+// namespaces
+// ----------
+
+namespace dt {
+namespace prog  {
+namespace deque  {
+
+// -------------------
+// deque_parallel_test
+// -------------------
+
+/**
+ * function deque_parallel_test is a tester of the parallel algorithms,
+ * instantiated with a Deque of an integral type
+ */
+template <typename Deque>
+void deque_parallel_test () {
+	typedef typename Deque::value_type value_type;
+	typedef typename Deque::size_type  size_type;
+	namespace ex = dt::prog::deque::execution;
+
+	{
+	// empty deque
+	Deque a;
+	dt::prog::deque::for_each(ex::par, a, [] (value_type& v) { ++v; });
+	assert(dt::prog::deque::reduce(ex::par, a) == 0);
+	const Deque& c = a;
+	assert(dt::prog::deque::find_if(ex::par, a, [] (value_type) { return true; }) == c.end());
+	}
+
+	{
+	// a pool of workers runs every task once
+	ThreadPool pool(3);
+	assert(pool.size() == 4);
+	std::atomic<int> sum(0);
+	for(int r = 0; r < 50; ++r)
+		pool.run(100, [&sum] (std::size_t i) { sum += (int)i; });
+	assert(sum == 50 * 4950);
+	}
+
+	{
+	// seq and par agree on a large misaligned deque
+	const size_type n = 300000;
+	Deque a;
+	for(size_type i = 0; i < 777; ++i)
+		a.push_front(0);
+	for(size_type i = 0; i < n; ++i)
+		a.push_back((value_type)(i % 1000));
+	for(size_type i = 0; i < 777; ++i)
+		a.pop_front();
+	ThreadPool pool(3);
+	ex::parallel_policy mine(&pool);
+
+	value_type s = dt::prog::deque::reduce(ex::seq, a);
+	assert(dt::prog::deque::reduce(ex::par, a) == s);
+	assert(dt::prog::deque::reduce(mine, a, 10, 20000, (value_type)0, std::plus<value_type>()) == dt::prog::deque::reduce(ex::seq, a, 10, 20000, (value_type)0, std::plus<value_type>()));
+
+	dt::prog::deque::for_each(mine, a, [] (value_type& v) { v *= 2; });
+	assert(dt::prog::deque::reduce(ex::par, a) == 2 * s);
+	assert(a[n - 1] == (value_type)(2 * ((n - 1) % 1000)));
+
+	Deque b;
+	for(size_type i = 0; i < n + 33; ++i)
+		b.push_back(-1);
+	dt::prog::deque::transform(ex::par, a, 0, n, b, 33, [] (value_type v) { return v / 2; });
+	assert(b[32] == -1);
+	for(size_type i = 0; i < n; i += 101)
+		assert(b[i + 33] == (value_type)(i % 1000));
+	assert(b[n + 32] == (value_type)((n - 1) % 1000));
+
+	Deque c;
+	for(size_type i = 0; i < n; ++i)
+		c.push_front(0);
+	dt::prog::deque::copy(ex::par, a, c);
+	assert(c == a);
+
+	dt::prog::deque::fill(ex::par, c, 5, n - 5, 3);
+	assert(c[4] == a[4] && c[5] == 3 && c[n - 6] == 3 && c[n - 5] == a[n - 5]);
+	}
+
+	{
+	// find_if returns the first match even when later pieces match first
+	const size_type n = 500000;
+	Deque a;
+	const Deque& c = a;
+	for(size_type i = 0; i < n; ++i)
+		a.push_back((value_type)(i % 7 == 0 && i > 100000));
+	for(size_type i = 0; i < 20; ++i){
+		size_type k = (size_type)(123457 * (i + 1)) % n;
+		a[k] = 2;
+		size_type e = 0;
+		while(a[e] != 2) ++e;
+		assert(dt::prog::deque::find_if(ex::par, a, [] (value_type v) { return v == 2; }) == c.begin() + e);
+		assert(dt::prog::deque::find_if(ex::seq, a, [] (value_type v) { return v == 2; }) == c.begin() + e);}
+	assert(dt::prog::deque::find_if(ex::par, a, 0, 100000, [] (value_type v) { return v == 1; }) == c.begin() + 100000);
+	assert(dt::prog::deque::find_if(ex::par, a, [] (value_type v) { return v == 1; }) == c.begin() + 100002);
+	}
+} // deque_parallel_test
+
+} // deque
+} // prog
+} // dt
+
+#endif // DequeParallelTest_h
@@ -0,0 +1,271 @@
+// ----------------------
+// prog/deque/DequePerf.h
+// Tj Wrenn
+// ----------------------
+
+#ifndef DequePerf_h
+#define DequePerf_h
+
+// --------
+// includes
+// --------
+
+#include <chrono>  // steady_clock
+#include <cstdio>  // printf, fflush
+#include <cstdlib> // rand, srand
+#include <cstring> // memset
+#include <vector>  // vector
+
+#ifdef __linux__
+#include <linux/perf_event.h> // perf_event_attr, PERF_*
+#include <sys/ioctl.h>        // ioctl
+#include <sys/syscall.h>      // SYS_perf_event_open
+#include <unistd.h>           // syscall, read, close
+#endif
+
+#include "Deque.h"
+#include "DequeBench.h"
+#include "HugePageAllocator.h"
+
+// ----------
+// namespaces
+// ----------
+
+namespace dt {
+namespace prog  {
+namespace deque  {
+
+// ------------
+// PerfCounters
+// ------------
+
+/**
+ * the hardware counters of the calling thread, read with perf_event_open:
+ * cycles, instructions, L1 data cache read misses, last level cache read
+ * misses, branch misses and data TLB read misses.  each counter is opened
+ * on its own, so one the CPU or the kernel refuses (perf_event_paranoid,
+ * a virtual machine, a kernel other than Linux) reads as unavailable and
+ * the others still count.
+ */
+class PerfCounters {
+public:
+	static const int counters = 6;
+
+	static const char* name (int i) {
+		static const char* const names[counters] = {"cycles", "instr", "L1d-miss", "LLC-miss", "br-miss", "dTLB-miss"};
+		return names[i];}
+
+private:
+	int fd[counters];
+
+	PerfCounters (const PerfCounters&);
+	PerfCounters& operator = (const PerfCounters&);
+
+#ifdef __linux__
+	static int open (unsigned type, unsigned long long config) {
+		struct perf_event_attr attr;
+		std::memset(&attr, 0, sizeof(attr));
+		attr.size = sizeof(attr);
+		attr.type = type;
+		attr.config = config;
+		attr.disabled = 1;
+		attr.exclude_kernel = 1;
+		attr.exclude_hv = 1;
+		return (int)syscall(SYS_perf_event_open, &attr, 0, -1, -1, 0);}
+
+	static unsigned long long cache (unsigned long long which) {
+		return which | (PERF_COUNT_HW_CACHE_OP_READ << 8) | (PERF_COUNT_HW_CACHE_RESULT_MISS << 16);}
+#endif
+
+public:
+	PerfCounters () {
+#ifdef __linux__
+		fd[0] = open(PERF_TYPE_HARDWARE, PERF_COUNT_HW_CPU_CYCLES);
+		fd[1] = open(PERF_TYPE_HARDWARE, PERF_COUNT_HW_INSTRUCTIONS);
+		fd[2] = open(PERF_TYPE_HW_CACHE, cache(PERF_COUNT_HW_CACHE_L1D));
+		fd[3] = open(PERF_TYPE_HW_CACHE, cache(PERF_COUNT_HW_CACHE_LL));
+		fd[4] = open(PERF_TYPE_HARDWARE, PERF_COUNT_HW_BRANCH_MISSES);
+		fd[5] = open(PERF_TYPE_HW_CACHE, cache(PERF_COUNT_HW_CACHE_DTLB));
+#else
+		for(int i = 0; i < counters; ++i)
+			fd[i] = -1;
+#endif
+	}
+
+	~PerfCounters () {
+#ifdef __linux__
+		for(int i = 0; i < counters; ++i)
+			if(fd[i] >= 0)
+				close(fd[i]);
+#endif
+	}
+
+	/**
+	 * @return true if counter i is counting
+	 */
+	bool available (int i) const {
+		return fd[i] >= 0;}
+
+	/**
+	 * zeroes and starts every available counter
+	 */
+	void start () {
+#ifdef __linux__
+		for(int i = 0; i < counters; ++i)
+			if(fd[i] >= 0){
+				ioctl(fd[i], PERF_EVENT_IOC_RESET, 0);
+				ioctl(fd[i], PERF_EVENT_IOC_ENABLE, 0);}
+#endif
+	}
+
+	/**
+	 * stops every available counter
+	 * @param v where to write the counts, 0 for an unavailable counter
+	 */
+	void stop (unsigned long long* v) {
+		for(int i = 0; i < counters; ++i){
+			v[i] = 0;
+#ifdef __linux__
+			if(fd[i] >= 0){
+				ioctl(fd[i], PERF_EVENT_IOC_DISABLE, 0);
+				if(read(fd[i], &v[i], sizeof(v[i])) != (ssize_t)sizeof(v[i]))
+					v[i] = 0;}
+#endif
+		}}};
+
+// --------
+// perf_run
+// --------
+
+/**
+ * runs f once to warm up and once under the counters, then prints the time
+ * and each counter per operation, or n/a for a counter that is unavailable
+ * @param counters the counters to read
+ * @param group benchmark group
+ * @param name what was measured
+ * @param ops number of operations in a run of f
+ * @param f work to measure
+ */
+template <typename F>
+void perf_run (PerfCounters& counters, const char* group, const char* name, double ops, F f) {
+	unsigned long long v[PerfCounters::counters];
+	f();
+	std::chrono::steady_clock::time_point t0 = std::chrono::steady_clock::now();
+	counters.start();
+	f();
+	counters.stop(v);
+	std::chrono::steady_clock::time_point t1 = std::chrono::steady_clock::now();
+	std::printf("%-16s %-22s %8.2f ns", group, name, std::chrono::duration<double, std::nano>(t1 - t0).count() / ops);
+	for(int i = 0; i < PerfCounters::counters; ++i)
+		if(counters.available(i))
+			std::printf(" %9.3f %s", v[i] / ops, PerfCounters::name(i));
+		else
+			std::printf(" %9s %s", "n/a", PerfCounters::name(i));
+	std::printf("\n");
+	std::fflush(stdout);}
+
+// ----------
+// perf_bench
+// ----------
+
+/**
+ * function perf_bench measures Deque's hot paths per operation: operator[]
+ * at random indices, an iterator scan, insert and erase near the middle, and
+ * push_back onto an empty deque, whose growth steps (ensureCapacity) show as
+ * the difference from push_back onto one cleared after growing to size
+ * @param counters the counters to read
+ * @param group label for the element type
+ * @param n number of elements
+ */
+template <typename Deque>
+void perf_bench (PerfCounters& counters, const char* group, int n) {
+	typedef typename Deque::value_type value_type;
+	std::vector<int> at(n);
+	std::srand(10);
+	for(int i = 0; i < n; ++i)
+		at[i] = std::rand() % n;
+
+	Deque a(n, 1);
+	perf_run(counters, group, "operator []", n, [&] () {
+		value_type x = 0;
+		for(int i = 0; i < n; ++i)
+			x += a[at[i]];
+		bench_sink(x);});
+	perf_run(counters, group, "iterator scan", n, [&] () {
+		value_type x = 0;
+		for(typename Deque::iterator i = a.begin(); i != a.end(); ++i)
+			x += *i;
+		bench_sink(x);});
+
+	const int m = 1 << 14;
+	const int ops = 1000;
+	Deque b(m, 1);
+	perf_run(counters, group, "insert middle", ops, [&] () {
+		for(int i = 0; i < ops; ++i)
+			b.insert(b.begin() + (b.size() / 2), (value_type)i);});
+	perf_run(counters, group, "erase middle", ops, [&] () {
+		for(int i = 0; i < ops; ++i)
+			b.erase(b.begin() + (b.size() / 2));});
+
+	perf_run(counters, group, "push_back growing", n, [&] () {
+		Deque c;
+		for(int i = 0; i < n; ++i)
+			c.push_back((value_type)i);
+		bench_sink(c.size());});
+	Deque d;
+	perf_run(counters, group, "push_back grown", n, [&] () {
+		d.clear();
+		for(int i = 0; i < n; ++i)
+			d.push_back((value_type)i);
+		bench_sink(d.size());});
+} // perf_bench
+
+// --------------
+// hugepage_bench
+// --------------
+
+/**
+ * function hugepage_bench compares random operator[] and an iterator scan on
+ * a Deque<int> whose blocks come from the heap with one whose blocks come
+ * from a prefaulted HugePageArena; the dTLB-miss column shows the difference
+ * @param counters the counters to read
+ * @param n number of elements
+ */
+inline void hugepage_bench (PerfCounters& counters, int n) {
+	std::vector<int> at(n);
+	std::srand(11);
+	for(int i = 0; i < n; ++i)
+		at[i] = std::rand() % n;
+
+	Deque<int> a(n, 1);
+	perf_run(counters, "heap blocks", "operator []", n, [&] () {
+		int x = 0;
+		for(int i = 0; i < n; ++i)
+			x += a[at[i]];
+		bench_sink(x);});
+	perf_run(counters, "heap blocks", "iterator scan", n, [&] () {
+		int x = 0;
+		for(Deque<int>::iterator i = a.begin(); i != a.end(); ++i)
+			x += *i;
+		bench_sink(x);});
+
+	HugePageArena arena(2 * (std::size_t)n * sizeof(int), HugePageArena::prefault);
+	HugePageAllocator<int> h(&arena);
+	Deque<int, HugePageAllocator<int> > b(n, 1, h);
+	perf_run(counters, "huge page blocks", "operator []", n, [&] () {
+		int x = 0;
+		for(int i = 0; i < n; ++i)
+			x += b[at[i]];
+		bench_sink(x);});
+	perf_run(counters, "huge page blocks", "iterator scan", n, [&] () {
+		int x = 0;
+		for(Deque<int, HugePageAllocator<int> >::iterator i = b.begin(); i != b.end(); ++i)
+			x += *i;
+		bench_sink(x);});
+} // hugepage_bench
+
+} // deque
+} // prog
+} // dt
+
+#endif // DequePerf_h
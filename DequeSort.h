@@ -0,0 +1,315 @@
+// ----------------------
+// prog/deque/DequeSort.h
+// Tj Wrenn
+// ----------------------
+
+#ifndef DequeSort_h
+#define DequeSort_h
+
+// --------
+// includes
+// --------
+
+#include <algorithm> // copy, merge, sort, stable_sort, swap
+#include <cstddef> // size_t
+#include <cstring> // memcpy
+#include <functional> // less
+#include <iterator> // make_move_iterator
+#include <type_traits> // integral_constant, is_floating_point, is_integral, is_signed
+#include <vector> // vector
+
+#include <stdint.h> // uint8_t, uint16_t, uint32_t, uint64_t
+
+#include "Deque.h"
+#include "DequeParallel.h"
+
+// ----------
+// namespaces
+// ----------
+
+namespace dt{
+namespace prog{
+namespace deque{
+
+// -------
+// sorting
+// -------
+
+/**
+* Sorting a Deque copies it into a scratch buffer and sorts that.  Integral
+* and floating point elements sorted by < get an LSD radix sort, one pass per
+* byte of the key, skipping bytes every element shares.  Anything else goes
+* to std::sort, which beats sorting blocks and merging them; stable_sort
+* sorts one block at a time, each block in cache, and merges the sorted
+* blocks pairwise between the buffer and a second one.  With execution::par
+* the deque is cut into one block-aligned piece per thread, each piece is
+* sorted that way on its own thread, and the pieces are merged in rounds, the
+* merges of a round running in parallel.  The result is moved back block by
+* block.
+*/
+namespace sorting{
+
+template <std::size_t N> struct unsigned_of;
+template <> struct unsigned_of<1> {typedef uint8_t type;};
+template <> struct unsigned_of<2> {typedef uint16_t type;};
+template <> struct unsigned_of<4> {typedef uint32_t type;};
+template <> struct unsigned_of<8> {typedef uint64_t type;};
+
+/**
+* true for the element types sorted by radix: integers other than bool, float and double
+*/
+template <typename T>
+struct is_radix : std::integral_constant<bool,
+	(std::is_integral<T>::value && !std::is_same<T, bool>::value && (sizeof(T) == 1 || sizeof(T) == 2 || sizeof(T) == 4 || sizeof(T) == 8)) ||
+	std::is_same<T, float>::value || std::is_same<T, double>::value> {};
+
+/**
+* @return an unsigned key whose order is the order of v under <; -0.0 gets the key of 0.0
+*/
+template <typename T>
+typename unsigned_of<sizeof(T)>::type key (T v, std::true_type){
+	typedef typename unsigned_of<sizeof(T)>::type U;
+	const U top = (U)1 << (sizeof(T) * 8 - 1);
+	if(v == 0) v = 0;
+	U u;
+	std::memcpy(&u, &v, sizeof(T));
+	return (u & top) ? (U)~u : (U)(u | top);}
+
+template <typename T>
+typename unsigned_of<sizeof(T)>::type key (T v, std::false_type){
+	typedef typename unsigned_of<sizeof(T)>::type U;
+	const U top = std::is_signed<T>::value ? (U)1 << (sizeof(T) * 8 - 1) : 0;
+	return (U)((U)v ^ top);}
+
+template <typename T>
+typename unsigned_of<sizeof(T)>::type key (T v){
+	return key(v, std::is_floating_point<T>());}
+
+/**
+* orders by key, so the merges agree with the radix sort on NaNs and signed zeros
+*/
+template <typename T>
+struct key_less{
+	bool operator () (T x, T y)const {
+		return key(x) < key(y);}};
+
+/**
+* stable LSD radix sort of [a, a + n), using [t, t + n) as scratch
+* O(n * sizeof(T))
+* M(1)
+* @return a or t, whichever holds the sorted elements
+*/
+template <typename T>
+T* radix (T* a, T* t, std::size_t n){
+	const std::size_t digits = sizeof(T);
+	std::vector<std::size_t> count(digits * 256, 0);
+	for(std::size_t i = 0; i < n; ++i){
+		typename unsigned_of<sizeof(T)>::type k = key(a[i]);
+		for(std::size_t d = 0; d < digits; ++d)
+			++count[d * 256 + ((k >> (d * 8)) & 255)];}
+	for(std::size_t d = 0; d < digits; ++d){
+		std::size_t* c = &count[d * 256];
+		bool skip = false;
+		std::size_t sum = 0;
+		for(std::size_t b = 0; b < 256; ++b){
+			skip = skip || c[b] == n;
+			std::size_t x = c[b];
+			c[b] = sum;
+			sum += x;}
+		if(skip)
+			continue;
+		for(std::size_t i = 0; i < n; ++i)
+			t[c[(key(a[i]) >> (d * 8)) & 255]++] = a[i];
+		std::swap(a, t);}
+	return a;}
+
+/**
+* calls f(i) for every i in [0, n), using policy
+*/
+template <typename F>
+void each (const execution::sequenced_policy&, std::size_t n, F f){
+	for(std::size_t i = 0; i < n; ++i)
+		f(i);}
+
+template <typename F>
+void each (const execution::parallel_policy& policy, std::size_t n, F f){
+	if(n == 1)
+		f(0);
+	else
+		policy.threads().run(n, f);}
+
+/**
+* merges the sorted runs [cuts[i], cuts[i + 1]) pairwise, back and forth
+* between a and t, until one run is left
+* O(n log r), where r is the number of runs
+* M(1)
+* @return a or t, whichever holds the merged run
+*/
+template <typename Policy, typename T, typename C>
+T* merge (const Policy& policy, T* a, T* t, std::vector<std::size_t> cuts, C comp){
+	while(cuts.size() > 2){
+		std::size_t runs = cuts.size() - 1;
+		each(policy, (runs + 1) / 2, [a, t, &cuts, &comp, runs] (std::size_t i) {
+			std::size_t lo = cuts[2 * i];
+			std::size_t mid = cuts[(2 * i + 1 < runs) ? 2 * i + 1 : runs];
+			std::size_t hi = cuts[(2 * i + 2 < runs) ? 2 * i + 2 : runs];
+			std::merge(std::make_move_iterator(a + lo), std::make_move_iterator(a + mid),
+				std::make_move_iterator(a + mid), std::make_move_iterator(a + hi), t + lo, comp);});
+		std::vector<std::size_t> next;
+		for(std::size_t i = 0; i < cuts.size(); i += 2)
+			next.push_back(cuts[i]);
+		if(next.back() != cuts.back())
+			next.push_back(cuts.back());
+		cuts.swap(next);
+		std::swap(a, t);}
+	return a;}
+
+/**
+* @return cuts at which to split [0, d.size()): one piece for seq, one block-aligned piece per thread for par
+*/
+template <typename T, typename A, typename S, typename O>
+std::vector<std::size_t> pieces (const execution::sequenced_policy&, const Deque<T, A, S, O>& d){
+	std::vector<std::size_t> cuts(1, 0);
+	cuts.push_back(d.size());
+	return cuts;}
+
+template <typename T, typename A, typename S, typename O>
+std::vector<std::size_t> pieces (const execution::parallel_policy& policy, const Deque<T, A, S, O>& d){
+	std::vector<typename Deque<T, A, S, O>::size_type> c = parallel::split(d, 0, d.size(), policy.threads().size());
+	return std::vector<std::size_t>(c.begin(), c.end());}
+
+/**
+* sorts [lo, hi) of a, which holds a copy of d: with std::sort, or for a
+* stable sort block by block and then by merging
+* @return a or t, whichever holds the sorted piece
+*/
+template <typename T, typename A, typename S, typename O, typename C>
+T* piece (const Deque<T, A, S, O>& d, T* a, T* t, std::size_t lo, std::size_t hi, C comp, bool stable, std::false_type){
+	if(!stable){
+		std::sort(a + lo, a + hi, comp);
+		return a;}
+	std::vector<std::size_t> cuts;
+	for(std::size_t i = lo; i < hi; i += d.segment_length(i)){
+		std::size_t n = d.segment_length(i);
+		if(n > hi - i) n = hi - i;
+		std::stable_sort(a + i, a + i + n, comp);
+		cuts.push_back(i);}
+	cuts.push_back(hi);
+	return sorting::merge(execution::seq, a, t, cuts, comp);}
+
+template <typename T, typename A, typename S, typename O, typename C>
+T* piece (const Deque<T, A, S, O>&, T* a, T* t, std::size_t lo, std::size_t hi, C, bool, std::true_type){
+	return radix(a + lo, t + lo, hi - lo) - lo;}
+
+/**
+* sorts d with comp; use_radix selects the radix sort, which orders by key()
+*/
+template <typename Policy, typename T, typename A, typename S, typename O, typename C, typename R>
+void sort (const Policy& policy, Deque<T, A, S, O>& d, C comp, bool stable, R use_radix){
+	typedef typename Deque<T, A, S, O>::size_type size_type;
+	const size_type n = d.size();
+	if(n < 2)
+		return;
+	std::vector<T> buffer;
+	buffer.reserve(n);
+	for(size_type i = 0; i < n; i += d.segment_length(i))
+		buffer.insert(buffer.end(), &d[i], &d[i] + d.segment_length(i));
+	std::vector<T> scratch(n, buffer[0]);
+	T* a = &buffer[0];
+	T* t = &scratch[0];
+
+	std::vector<std::size_t> cuts = pieces(policy, d);
+	each(policy, cuts.size() - 1, [&d, a, t, &cuts, &comp, stable, use_radix] (std::size_t i) {
+		std::size_t lo = cuts[i];
+		std::size_t hi = cuts[i + 1];
+		if(piece(d, a, t, lo, hi, comp, stable, use_radix) != a)
+			std::copy(std::make_move_iterator(t + lo), std::make_move_iterator(t + hi), a + lo);});
+	T* r = sorting::merge(policy, a, t, cuts, comp);
+
+	parallel::run(policy, d, 0, n, [&d, r] (size_type i, size_type e) {
+		while(i < e){
+			size_type k = d.segment_length(i);
+			if(k > e - i) k = e - i;
+			std::copy(std::make_move_iterator(r + i), std::make_move_iterator(r + i + k), &d[i]);
+			i += k;}});}
+
+} // sorting
+
+// ----
+// sort
+// ----
+
+/**
+* sorts d by <, with a radix sort for integral and floating point elements
+* (-0.0 and 0.0 are kept in their original order; NaNs go to the ends)
+* O(n log n), or O(n * sizeof(T)) for the radix sort
+* M(n)
+* @param policy execution::seq or execution::par
+* @param d a deque
+*/
+template <typename Policy, typename T, typename A, typename S, typename O>
+void sort (const Policy& policy, Deque<T, A, S, O>& d){
+	typedef typename std::conditional<sorting::is_radix<T>::value, sorting::key_less<T>, std::less<T> >::type compare;
+	sorting::sort(policy, d, compare(), false, sorting::is_radix<T>());}
+
+/**
+* sorts d by comp
+* O(n log n)
+* M(n)
+* @param policy execution::seq or execution::par
+* @param d a deque
+* @param comp strict weak ordering
+*/
+template <typename Policy, typename T, typename A, typename S, typename O, typename C>
+void sort (const Policy& policy, Deque<T, A, S, O>& d, C comp){
+	sorting::sort(policy, d, comp, false, std::false_type());}
+
+template <typename T, typename A, typename S, typename O>
+void sort (Deque<T, A, S, O>& d){
+	sort(execution::seq, d);}
+
+template <typename T, typename A, typename S, typename O, typename C>
+void sort (Deque<T, A, S, O>& d, C comp){
+	sort(execution::seq, d, comp);}
+
+// -----------
+// stable_sort
+// -----------
+
+/**
+* sorts d by <, keeping equal elements in their original order
+* O(n log n), or O(n * sizeof(T)) for the radix sort
+* M(n)
+* @param policy execution::seq or execution::par
+* @param d a deque
+*/
+template <typename Policy, typename T, typename A, typename S, typename O>
+void stable_sort (const Policy& policy, Deque<T, A, S, O>& d){
+	typedef typename std::conditional<sorting::is_radix<T>::value, sorting::key_less<T>, std::less<T> >::type compare;
+	sorting::sort(policy, d, compare(), true, sorting::is_radix<T>());}
+
+/**
+* sorts d by comp, keeping equal elements in their original order
+* O(n log n)
+* M(n)
+* @param policy execution::seq or execution::par
+* @param d a deque
+* @param comp strict weak ordering
+*/
+template <typename Policy, typename T, typename A, typename S, typename O, typename C>
+void stable_sort (const Policy& policy, Deque<T, A, S, O>& d, C comp){
+	sorting::sort(policy, d, comp, true, std::false_type());}
+
+template <typename T, typename A, typename S, typename O>
+void stable_sort (Deque<T, A, S, O>& d){
+	stable_sort(execution::seq, d);}
+
+template <typename T, typename A, typename S, typename O, typename C>
+void stable_sort (Deque<T, A, S, O>& d, C comp){
+	stable_sort(execution::seq, d, comp);}
+
+} // deque
+} // prog
+} // dt
+
+#endif // DequeSort_h
@@ -0,0 +1,125 @@
+// --------------------------
+// prog/deque/DequeSortTest.h
+// Tj Wrenn
+// --------------------------
+
+#ifndef DequeSortTest_h
+#define DequeSortTest_h
+
+// --------
+// includes
+// --------
+
+#include <algorithm> // is_sorted, sort, stable_sort
+#include <cassert>   // assert
+#include <cstdlib>   // rand, srand
+#include <functional> // greater
+#include <limits>    // numeric_limits
+#include <utility>   // pair
+#include <vector>    // vector
+
+#include "DequeSort.h"
+
+// ----------
+// namespaces
+// ----------
+
+namespace dt {
+namespace prog  {
+namespace deque  {
+
+// ---------------
+// deque_sort_test
+// ---------------
+
+/**
+ * function deque_sort_test is a tester of sort and stable_sort, instantiated
+ * with a Deque of an arithmetic type
+ */
+template <typename Deque>
+void deque_sort_test () {
+	typedef typename Deque::value_type value_type;
+	typedef typename Deque::size_type  size_type;
+	namespace ex = dt::prog::deque::execution;
+
+	{
+	// agree with std::sort on every segment shape, seq and par
+	std::srand(11);
+	for(int r = 0; r < 24; ++r){
+		Deque a;
+		int n = (r < 20) ? std::rand() % 3000 : 100000 + std::rand() % 1000;
+		int lead = std::rand() % 300;
+		for(int i = 0; i < lead; ++i)
+			a.push_front(0);
+		std::vector<value_type> v;
+		for(int i = 0; i < n; ++i){
+			value_type x = (value_type)(std::rand() % 20001 - 10000) / (value_type)((r % 3) + 1);
+			a.push_back(x);
+			v.push_back(x);}
+		for(int i = 0; i < lead; ++i)
+			a.pop_front();
+		std::sort(v.begin(), v.end());
+
+		Deque b(a);
+		Deque c(a);
+		Deque e(a);
+		if(r % 2)
+			dt::prog::deque::sort(a);
+		else
+			dt::prog::deque::stable_sort(a);
+		dt::prog::deque::sort(ex::par, b);
+		dt::prog::deque::sort(c, std::greater<value_type>());
+		dt::prog::deque::stable_sort(ex::par, e, std::greater<value_type>());
+		assert(a.size() == (size_type)n);
+		for(int i = 0; i < n; ++i){
+			assert(a[i] == v[i]);
+			assert(b[i] == v[i]);
+			assert(c[i] == v[n - 1 - i]);
+			assert(e[i] == v[n - 1 - i]);}}
+	}
+
+	{
+	// extremes of the key
+	Deque a;
+	a.push_back(std::numeric_limits<value_type>::max());
+	a.push_back(0);
+	a.push_back(std::numeric_limits<value_type>::lowest());
+	a.push_back(1);
+	a.push_back(-1);
+	dt::prog::deque::sort(a);
+	assert(a[0] == std::numeric_limits<value_type>::lowest());
+	assert(a[1] == -1 && a[2] == 0 && a[3] == 1);
+	assert(a[4] == std::numeric_limits<value_type>::max());
+	}
+} // deque_sort_test
+
+/**
+ * function deque_stable_sort_test checks that stable_sort keeps equal
+ * elements in order, instantiated with a Deque of pairs
+ */
+template <typename Deque>
+void deque_stable_sort_test () {
+	typedef typename Deque::value_type value_type;
+	namespace ex = dt::prog::deque::execution;
+
+	std::srand(13);
+	const int n = 60000;
+	Deque a;
+	for(int i = 0; i < n; ++i)
+		a.push_back(value_type(std::rand() % 50, i));
+	Deque b(a);
+	struct first_less{
+		bool operator () (const value_type& x, const value_type& y)const {
+			return x.first < y.first;}};
+	dt::prog::deque::stable_sort(a, first_less());
+	dt::prog::deque::stable_sort(ex::par, b, first_less());
+	for(int i = 1; i < n; ++i){
+		assert(a[i - 1].first < a[i].first || (a[i - 1].first == a[i].first && a[i - 1].second < a[i].second));
+		assert(b[i] == a[i]);}
+} // deque_stable_sort_test
+
+} // deque
+} // prog
+} // dt
+
+#endif // DequeSortTest_h
@@ -0,0 +1,140 @@
+// -----------------------
+// prog/deque/DequeStats.h
+// Tj Wrenn
+// -----------------------
+
+#ifndef DequeStats_h
+#define DequeStats_h
+
+// --------
+// includes
+// --------
+
+#include <cstddef> // size_t
+
+// ----------
+// namespaces
+// ----------
+
+namespace dt{
+namespace prog{
+namespace deque{
+
+// -------
+// NoStats
+// -------
+
+/**
+* The default statistics policy of Deque: every hook is empty and inline, and
+* Deque holds its policy as an empty base, so a Deque without statistics
+* costs exactly what it did before there were any.
+*
+* A policy provides the hooks below.  Deque calls them as things happen,
+* except measured(), which stats() calls on the copy it returns, with
+* figures it works out then.
+*/
+struct NoStats{
+	typedef std::size_t size_type;
+
+	/**
+	* the capacity grew from oldCapacity to newCapacity elements
+	*/
+	void grown (size_type, size_type){}
+
+	/**
+	* a block of the given size was allocated, or freed
+	*/
+	void block_allocated (size_type){}
+	void block_freed (size_type){}
+
+	/**
+	* the size grew to n
+	*/
+	void sized (size_type){}
+
+	/**
+	* n elements were moved to open or close a gap in the middle
+	*/
+	void shifted (size_type){}
+
+	/**
+	* the deque holds bytesUsed bytes of elements in bytesReserved bytes of
+	* blocks and outer array, with room for capacity elements
+	*/
+	void measured (size_type, size_type, size_type){}};
+
+// ----------
+// DequeStats
+// ----------
+
+/**
+* A statistics policy that counts: Deque<T, A, DequeStats>::stats() returns
+* one of these, for spotting over-provisioned deques in a running service.
+* Counting costs a few adds per push and per growth step.
+*/
+struct DequeStats{
+	typedef std::size_t size_type;
+
+	/**
+	* number of times the outer array was reallocated to grow the capacity
+	*/
+	unsigned long long growths;
+
+	/**
+	* number of blocks allocated and freed by this deque; blocks handed over by
+	* append(), split_at() and splice() move without being counted
+	*/
+	unsigned long long blocks_allocated;
+	unsigned long long blocks_freed;
+
+	/**
+	* number of elements moved by insert and erase in the middle
+	*/
+	unsigned long long elements_shifted;
+
+	/**
+	* largest size and capacity reached, in elements
+	*/
+	size_type peak_size;
+	size_type peak_capacity;
+
+	/**
+	* bytes of elements, and bytes of blocks and outer array holding them,
+	* as of the stats() call that returned this copy
+	*/
+	size_type bytes_used;
+	size_type bytes_reserved;
+
+	DequeStats ()
+		: growths(0), blocks_allocated(0), blocks_freed(0), elements_shifted(0),
+		  peak_size(0), peak_capacity(0), bytes_used(0), bytes_reserved(0) {}
+
+	void grown (size_type, size_type newCapacity){
+		++growths;
+		if(newCapacity > peak_capacity)
+			peak_capacity = newCapacity;}
+
+	void block_allocated (size_type){
+		++blocks_allocated;}
+
+	void block_freed (size_type){
+		++blocks_freed;}
+
+	void sized (size_type n){
+		if(n > peak_size)
+			peak_size = n;}
+
+	void shifted (size_type n){
+		elements_shifted += n;}
+
+	void measured (size_type used, size_type reserved, size_type capacity){
+		bytes_used = used;
+		bytes_reserved = reserved;
+		if(capacity > peak_capacity)
+			peak_capacity = capacity;}};
+
+} // deque
+} // prog
+} // dt
+
+#endif // DequeStats_h
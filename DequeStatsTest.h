@@ -0,0 +1,135 @@
+// ---------------------------
+// prog/deque/DequeStatsTest.h
+// Tj Wrenn
+// ---------------------------
+
+#ifndef DequeStatsTest_h
+#define DequeStatsTest_h
+
+// --------
+// includes
+// --------
+
+#include <cassert> // assert
+#include <utility> // move
+
+#include "DequeStats.h"
+
+// ----------
+// namespaces
+// ----------
+
+namespace dt {
+namespace prog  {
+namespace deque  {
+
+// ----------------
+// deque_stats_test
+// ----------------
+
+/**
+ * function deque_stats_test is a tester of Deque's stats(), instantiated
+ * with an integral type and the DequeStats policy
+ */
+template <typename Deque>
+void deque_stats_test () {
+	typedef typename Deque::value_type value_type;
+	typedef typename Deque::size_type  size_type;
+	typedef typename Deque::stats_type stats_type;
+
+	{
+	Deque x;
+	const stats_type st = x.stats();
+	assert(st.growths == 0);
+	assert(st.peak_size == 0);
+	assert(st.elements_shifted == 0);
+	assert(st.bytes_used == 0);
+	assert(st.bytes_reserved > 0);
+	assert(st.blocks_allocated == 1);
+	}
+
+	{
+	Deque x;
+	for(int i = 0; i < 1000; ++i)
+		x.push_back(value_type(i));
+	for(int i = 0; i < 1000; ++i)
+		x.push_front(value_type(i));
+	stats_type st = x.stats();
+	assert(st.growths > 0);
+	assert(st.peak_size == 2000);
+	assert(st.peak_capacity >= 2000);
+	assert(st.blocks_allocated > 1);
+	assert(st.blocks_freed == 0);
+	assert(st.bytes_used == 2000 * sizeof(value_type));
+	assert(st.bytes_reserved >= st.bytes_used);
+	assert(st.elements_shifted == 0);
+
+	size_type growths = st.growths;
+	x.clear();
+	assert(st.bytes_used == 2000 * sizeof(value_type)); // a snapshot
+	st = x.stats();
+	assert(st.peak_size == 2000);
+	assert(st.bytes_used == 0);
+	assert(st.growths == growths);
+	}
+
+	{
+	Deque x;
+	for(int i = 0; i < 10; ++i)
+		x.push_back(value_type(i));
+	x.insert(x.begin() + 3, value_type(-1));
+	assert(x.stats().elements_shifted == 3);
+	x.erase(x.begin() + 7);
+	assert(x.stats().elements_shifted == 6);
+	x.erase(x.begin() + 1, x.begin() + 3);
+	assert(x.stats().elements_shifted == 7);
+	assert(x.size() == 8);
+	assert(x.stats().peak_size == 11);
+	}
+
+	{
+	Deque x;
+	Deque y;
+	for(int i = 0; i < 500; ++i)
+		x.push_back(value_type(i));
+	x.swap(y);
+	assert(x.stats().peak_size == 500);
+	assert(y.stats().peak_size == 0);
+	assert(y.stats().bytes_used == 500 * sizeof(value_type));
+	Deque z = y.split_at(100);
+	assert(z.stats().peak_size == 400);
+	y.append(std::move(z));
+	assert(y.stats().peak_size == 500);
+	}
+
+	{
+	// copy assignment keeps this deque's statistics
+	Deque x;
+	for(int i = 0; i < 300; ++i)
+		x.push_back(value_type(i));
+	const Deque y(10, value_type(1));
+	x = y;
+	assert(x.size() == 10);
+	assert(x.stats().peak_size == 300);
+	assert(x.stats().bytes_used == 10 * sizeof(value_type));
+	}
+
+	{
+	// a const deque hands out a snapshot without being written to
+	const Deque x(5, value_type(1));
+	const stats_type st = x.stats();
+	assert(st.bytes_used == 5 * sizeof(value_type));
+	assert(x.stats().peak_size == 5);
+	}
+
+	{
+	typedef ::dt::prog::deque::Deque<value_type> plain; // NoStats, an empty base
+	assert(sizeof(plain) + sizeof(stats_type) == sizeof(Deque));
+	}
+} // deque_stats_test
+
+} // deque
+} // prog
+} // dt
+
+#endif // DequeStatsTest_h
@@ -0,0 +1,353 @@
+// -----------------------
+// prog/deque/DequeSuite.h
+// Tj Wrenn
+// -----------------------
+
+#ifndef DequeSuite_h
+#define DequeSuite_h
+
+// --------
+// includes
+// --------
+
+#include <cstddef>   // size_t
+#include <cstdio>    // printf, fflush
+#include <cstdlib>   // rand, srand
+#include <cstring>   // memset
+#include <deque>     // deque
+#include <memory>    // allocator
+#include <type_traits> // integral_constant, true_type, false_type
+#include <vector>    // vector
+
+#ifdef __unix__
+#include <sys/resource.h> // getrusage
+#include <sys/wait.h>     // waitpid
+#include <unistd.h>       // fork, _exit
+#endif
+
+#include "Deque.h"
+#include "DequeBench.h"
+
+// ----------
+// namespaces
+// ----------
+
+namespace dt {
+namespace prog  {
+namespace deque  {
+
+// ----
+// Item
+// ----
+
+/**
+ * an element of N bytes; the first byte carries the value
+ */
+template <std::size_t N>
+struct Item {
+	unsigned char b[N];
+
+	Item () {
+		std::memset(b, 0, N);}
+
+	Item (int v) {
+		std::memset(b, 0, N);
+		b[0] = (unsigned char)v;}
+
+	unsigned value () const {
+		return b[0];}};
+
+// ----------
+// RingBuffer
+// ----------
+
+/**
+ * a circular buffer over one contiguous array, the boost::circular_buffer
+ * layout, doubling when full so it can stand in for an unbounded queue
+ */
+template <typename T>
+class RingBuffer {
+public:
+	typedef T value_type;
+	typedef std::size_t size_type;
+
+	class const_iterator {
+		friend class RingBuffer;
+		const RingBuffer* r;
+		size_type i;
+	public:
+		const T& operator * () const {
+			return (*r)[i];}
+		const_iterator& operator ++ () {
+			++i;
+			return *this;}
+		bool operator != (const const_iterator& that) const {
+			return i != that.i;}};
+
+private:
+	std::allocator<T> a;
+	T* p;
+	size_type cap;
+	size_type head;
+	size_type s;
+
+	T* slot (size_type i) const {
+		return p + ((head + i) & (cap - 1));}
+
+	void grow () {
+		size_type n = cap ? cap * 2 : 16;
+		T* q = a.allocate(n);
+		for(size_type i = 0; i < s; ++i){
+			a.construct(q + i, *slot(i));
+			a.destroy(slot(i));}
+		if(p)
+			a.deallocate(p, cap);
+		p = q;
+		cap = n;
+		head = 0;}
+
+public:
+	RingBuffer ()
+		: p(0), cap(0), head(0), s(0) {}
+
+	RingBuffer (size_type n, const T& v)
+		: p(0), cap(0), head(0), s(0) {
+		while(cap < n)
+			grow();
+		for(; s < n; ++s)
+			a.construct(p + s, v);}
+
+	RingBuffer (const RingBuffer& that)
+		: p(0), cap(0), head(0), s(0) {
+		while(cap < that.s)
+			grow();
+		for(; s < that.s; ++s)
+			a.construct(p + s, that[s]);}
+
+	~RingBuffer () {
+		for(size_type i = 0; i < s; ++i)
+			a.destroy(slot(i));
+		if(p)
+			a.deallocate(p, cap);}
+
+	T& operator [] (size_type i) {
+		return *slot(i);}
+
+	const T& operator [] (size_type i) const {
+		return *slot(i);}
+
+	const_iterator begin () const {
+		const_iterator x;
+		x.r = this;
+		x.i = 0;
+		return x;}
+
+	const_iterator end () const {
+		const_iterator x;
+		x.r = this;
+		x.i = s;
+		return x;}
+
+	void push_back (const T& v) {
+		if(s == cap)
+			grow();
+		a.construct(slot(s), v);
+		++s;}
+
+	void push_front (const T& v) {
+		if(s == cap)
+			grow();
+		head = (head - 1) & (cap - 1);
+		a.construct(slot(0), v);
+		++s;}
+
+	void pop_back () {
+		a.destroy(slot(--s));}
+
+	void pop_front () {
+		a.destroy(slot(0));
+		head = (head + 1) & (cap - 1);
+		--s;}
+
+	size_type size () const {
+		return s;}
+
+private:
+	RingBuffer& operator = (const RingBuffer&);};
+
+// ------------
+// suite_traits
+// ------------
+
+/**
+ * which scenarios a container supports: std::vector has no cheap front, and
+ * RingBuffer no insert or erase in the middle
+ */
+template <typename C>
+struct suite_traits {
+	static const bool front = true;
+	static const bool middle = true;};
+
+template <typename T, typename A>
+struct suite_traits< std::vector<T, A> > {
+	static const bool front = false;
+	static const bool middle = true;};
+
+template <typename T>
+struct suite_traits< RingBuffer<T> > {
+	static const bool front = true;
+	static const bool middle = false;};
+
+// ---------
+// suite_run
+// ---------
+
+/**
+ * times f in a child process of its own and prints ns/op, Mop/s and peak RSS.
+ * the child's peak covers this scenario and what the driver had already
+ * touched, such as the input container the scenario reads, but no earlier
+ * scenario.  without fork, f runs in process and the RSS column reads 0
+ * @param group benchmark group
+ * @param name what was timed
+ * @param ops number of operations in a run of f
+ * @param f work to time, including any setup it needs
+ */
+template <typename F>
+void suite_run (const char* group, const char* name, double ops, F f) {
+	std::fflush(stdout);
+#ifdef __unix__
+	pid_t pid = fork();
+	if(pid == 0){
+		double ns = bench_time(f, 3);
+		struct rusage u;
+		getrusage(RUSAGE_SELF, &u);
+		std::printf("%-24s %-24s %10.3f ns/op %10.1f Mop/s %8.1f MB\n", group, name, ns / ops, ops * 1e3 / ns, u.ru_maxrss / 1024.0);
+		std::fflush(stdout);
+		_exit(0);}
+	int status;
+	waitpid(pid, &status, 0);
+#else
+	double ns = bench_time(f, 3);
+	std::printf("%-24s %-24s %10.3f ns/op %10.1f Mop/s %8.1f MB\n", group, name, ns / ops, ops * 1e3 / ns, 0.0);
+#endif
+}
+
+// -----------
+// suite_bench
+// -----------
+
+/**
+ * push and pop at the front, and a FIFO of 1024 elements at steady state,
+ * for containers with a cheap front
+ */
+template <typename C>
+void suite_front (const char*, int, std::false_type) {}
+
+template <typename C>
+void suite_front (const char* group, int n, std::true_type) {
+	typedef typename C::value_type value_type;
+	suite_run(group, "push_front, pop_front", 2.0 * n, [&] () {
+		C c;
+		for(int i = 0; i < n; ++i)
+			c.push_front(value_type(i));
+		for(int i = 0; i < n; ++i)
+			c.pop_front();
+		bench_sink(c.size());});
+	suite_run(group, "fifo", 2.0 * n, [&] () {
+		C c;
+		for(int i = 0; i < 1024; ++i)
+			c.push_back(value_type(i));
+		for(int i = 0; i < n; ++i){
+			c.push_back(value_type(i));
+			c.pop_front();}
+		bench_sink(c.size());});}
+
+/**
+ * insert and erase near the middle of 16K elements, for containers that have them
+ */
+template <typename C>
+void suite_middle (const char*, std::false_type) {}
+
+template <typename C>
+void suite_middle (const char* group, std::true_type) {
+	typedef typename C::value_type value_type;
+	const int m = 1 << 14;
+	const int ops = 2000;
+	suite_run(group, "insert, erase middle", 2.0 * ops, [&] () {
+		C c(m, value_type(1));
+		for(int i = 0; i < ops; ++i)
+			c.insert(c.begin() + (m / 2 + i % 7), value_type(i));
+		for(int i = 0; i < ops; ++i)
+			c.erase(c.begin() + (m / 2 + i % 5));
+		bench_sink(c.size());});}
+
+/**
+ * function suite_bench runs the container scenarios on C: push and pop at
+ * each end, a FIFO at steady state, random access, a sequential scan, insert
+ * and erase in the middle, copying and constructing, each over n elements
+ * @param group label for the container and element size
+ * @param n number of elements
+ */
+template <typename C>
+void suite_bench (const char* group, int n) {
+	typedef typename C::value_type value_type;
+
+	suite_run(group, "push_back, pop_back", 2.0 * n, [&] () {
+		C c;
+		for(int i = 0; i < n; ++i)
+			c.push_back(value_type(i));
+		for(int i = 0; i < n; ++i)
+			c.pop_back();
+		bench_sink(c.size());});
+	suite_front<C>(group, n, std::integral_constant<bool, suite_traits<C>::front>());
+
+	std::vector<int> at(n);
+	std::srand(9);
+	for(int i = 0; i < n; ++i)
+		at[i] = std::rand() % n;
+	C c(n, value_type(1));
+	suite_run(group, "random access", n, [&] () {
+		unsigned x = 0;
+		for(int i = 0; i < n; ++i)
+			x += c[at[i]].value();
+		bench_sink(x);});
+	suite_run(group, "scan", n, [&] () {
+		unsigned x = 0;
+		const C& r = c;
+		for(typename C::const_iterator i = r.begin(); i != r.end(); ++i)
+			x += (*i).value();
+		bench_sink(x);});
+	suite_middle<C>(group, std::integral_constant<bool, suite_traits<C>::middle>());
+	suite_run(group, "copy", n, [&] () {
+		C d(c);
+		bench_sink(d.size());});
+	suite_run(group, "construct", n, [&] () {
+		C d(n, value_type(2));
+		bench_sink(d.size());});
+} // suite_bench
+
+/**
+ * function suite_sizes runs suite_bench on Deque, std::deque, std::vector and
+ * RingBuffer, all holding 16 MB of elements of N bytes
+ * @param label element size, e.g. "16B"
+ */
+template <std::size_t N>
+void suite_sizes (const char* label) {
+	typedef Item<N> T;
+	const int n = (int)((16u << 20) / N);
+	char group[64];
+	std::sprintf(group, "Deque<%s>", label);
+	suite_bench< Deque<T> >(group, n);
+	std::sprintf(group, "std::deque<%s>", label);
+	suite_bench< std::deque<T> >(group, n);
+	std::sprintf(group, "std::vector<%s>", label);
+	suite_bench< std::vector<T> >(group, n);
+	std::sprintf(group, "RingBuffer<%s>", label);
+	suite_bench< RingBuffer<T> >(group, n);
+} // suite_sizes
+
+} // deque
+} // prog
+} // dt
+
+#endif // DequeSuite_h
@@ -10,9 +10,15 @@
 // includes
 // --------
 
+#include <algorithm> // rotate
 #include <cassert>   // assert
+#include <cstdlib>   // rand, srand
+#include <iterator>  // back_inserter, istream_iterator
+#include <sstream>   // istringstream
 #include <stdexcept> // out_of_range
 #include <string>    // string
+#include <utility>   // move
+#include <vector>    // vector
 
 // ----------
 // namespaces
@@ -22,6 +28,133 @@ namespace dt {
 namespace prog  {
 namespace deque  {
 
+// ------------------
+// deque_test_counted
+// ------------------
+
+/**
+ * an element that counts how often it is copied, to check that moving
+ * elements around inside a deque does not copy them
+ */
+struct deque_test_counted {
+	int v;
+
+	static int& copies () {
+		static int n = 0;
+		return n;}
+
+	deque_test_counted (int v = 0) : v(v) {}
+	deque_test_counted (const deque_test_counted& that) : v(that.v) {
+		++copies();}
+	deque_test_counted (deque_test_counted&& that) : v(that.v) {}
+	deque_test_counted& operator = (const deque_test_counted& that) {
+		v = that.v;
+		++copies();
+		return *this;}
+	deque_test_counted& operator = (deque_test_counted&& that) {
+		v = that.v;
+		return *this;}};
+
+// ---------------
+// deque_test_wide
+// ---------------
+
+/**
+ * an element too large for more than two to a block, so that a deque of a
+ * few thousand of them has an outer array that takes many pushes to migrate
+ */
+struct deque_test_wide {
+	int v;
+	char pad[256];
+
+	deque_test_wide (int v = 0) : v(v) {}
+	operator int () const {
+		return v;}};
+
+// --------------------
+// deque_test_migration
+// --------------------
+
+/**
+ * function deque_test_migration runs a random mix of pushes, pops, rotations,
+ * splits, appends, resizes, copies and reserves against a vector, on many small
+ * deques, so that many of them land while a push is part way through moving
+ * the outer array
+ */
+template <typename Deque>
+void deque_test_migration () {
+	typedef typename Deque::size_type size_type;
+	std::srand(11);
+	size_type bs = 0;
+	Deque t(1000, 0);
+	for(size_type i = 0; i < t.size(); ++i)
+		if(t.segment_length(i) > bs)
+			bs = t.segment_length(i);
+	for(int round = 0; round < 200; ++round){ // small deques, so that they migrate often
+		bool fifo = round % 2 == 1;     // pushes at one end, pops at the other: same-size migrations
+		Deque a;
+		std::vector<int> v;
+		for(int i = 0; i < 1500; ++i){
+			int r = std::rand() % 100;
+			if(r < 42){
+				a.push_back(i);
+				v.push_back(i);}
+			else if(r < 84 && !fifo){
+				a.push_front(i);
+				v.insert(v.begin(), i);}
+			else if(r < 84){
+				if(!v.empty()){
+					a.pop_front();
+					v.erase(v.begin());}}
+			else if(r < 88 && !v.empty()){
+				a.pop_front();
+				v.erase(v.begin());}
+			else if(r < 90 && !v.empty()){
+				a.pop_back();
+				v.pop_back();}
+			else if(r < 94 && !v.empty()){
+				while(v.size() % bs != 0 && v.size() > bs){ // the rotation of block pointers
+					a.pop_back();
+					v.pop_back();}
+				size_type k = std::rand() % v.size();
+				a.rotate(k);
+				std::rotate(v.begin(), v.begin() + k, v.end());}
+			else if(r < 98){
+				size_type k = v.empty() ? 0 : std::rand() % v.size();
+				Deque b = a.split_at(k);
+				std::vector<int> w;
+				for(int j = 0; j < (int)(2 * bs); ++j){ // b's blocks come back two slots further on
+					if(r % 2 == 0){
+						a.push_back(j);
+						w.push_back(j);}
+					else{
+						b.push_front(j);
+						w.insert(w.begin(), j);}}
+				a.append(std::move(b));
+				v.insert(v.begin() + k, w.begin(), w.end());}
+			else if(r < 99){
+				Deque b;
+				for(int j = 0; j < 8; ++j)
+					b.push_front(-j);
+				for(int j = 7; j >= 0; --j)
+					v.push_back(-j);
+				a.append(std::move(b));}
+			else{
+				a.resize(v.size() + 2 * bs + 1, i);
+				v.resize(v.size() + 2 * bs + 1, i);}
+			if(i % 500 == 499){ // each of these finishes a migration under way
+				Deque b(a);
+				a.swap(b);
+				assert(b == a);
+				a.reserve_back(std::rand() % 300);}
+			if(!v.empty()){
+				size_type k = std::rand() % v.size();
+				assert(a[k] == v[k]);}}
+		assert(a.size() == v.size());
+		for(size_type i = 0; i < v.size(); ++i)
+			assert(a[i] == v[i]);}
+} // deque_test_migration
+
 // ----------
 // deque_test
 // ----------
@@ -453,6 +586,374 @@ void deque_test () {
 	assert(a[3] == 5); 
 	}
 	
+	{
+	// append(that), prepend(that)
+	for(int off = 0; off < 25; ++off){
+		Deque a;
+		Deque b;
+		for(int i = 0; i < 100; ++i)
+			a.push_back(i);
+		for(int i = 0; i < off; ++i) // vary the alignment of b's front
+			b.push_back(-1);
+		for(int i = 100; i < 317; ++i)
+			b.push_back(i);
+		for(int i = 0; i < off; ++i)
+			b.pop_front();
+
+		a.append(std::move(b));
+		assert(b.empty());
+		assert(a.size() == 317);
+		for(int i = 0; i < 317; ++i)
+			assert(a[i] == i);
+
+		b.push_back(-2);
+		Deque c(3, -3);
+		c.prepend(std::move(b));
+		assert(c.size() == 4);
+		assert(c[0] == -2);
+		assert(c[3] == -3);
+
+		c.prepend(std::move(a));
+		assert(c.size() == 321);
+		assert(c[316] == 316);
+		assert(c[317] == -2);
+		assert(c.back() == -3);
+		}
+	}
+
+	{
+	// split_at(index), splice(pos, that)
+	for(int at = 0; at <= 103; at += 7){
+		Deque a;
+		for(int i = 0; i < 103; ++i)
+			a.push_back(i);
+		Deque b = a.split_at(at);
+		assert(a.size() == (size_type)at);
+		assert(b.size() == (size_type)(103 - at));
+		for(int i = 0; i < at; ++i)
+			assert(a[i] == i);
+		for(int i = at; i < 103; ++i)
+			assert(b[i - at] == i);
+		b.push_front(-1);
+		a.push_back(-1);
+		assert(b.front() == -1);
+		assert(a.back() == -1);
+		}
+
+	Deque a(40, 1);
+	Deque b(25, 2);
+	a.splice(a.begin() + 15, std::move(b));
+	assert(a.size() == 65);
+	assert(b.empty());
+	assert(a[14] == 1);
+	assert(a[15] == 2);
+	assert(a[39] == 2);
+	assert(a[40] == 1);
+
+	try {
+		a.split_at(66);
+		assert(false);
+	} catch (const std::out_of_range& e) {
+		assert(std::string(e.what()) == "deque split_at out of range");
+	}
+	}
+
+	{
+	// append, prepend, split_at and splice move elements rather than copy them,
+	// whether or not the seam is aligned
+	typedef ::dt::prog::deque::Deque<deque_test_counted> counted;
+	for(int off = 0; off < 5; ++off){
+		counted a;
+		counted b;
+		counted c;
+		for(int i = 0; i < 100; ++i)
+			a.push_back(deque_test_counted(i));
+		for(int i = 0; i < off; ++i)
+			b.push_back(deque_test_counted(-1));
+		for(int i = 100; i < 317; ++i)
+			b.push_back(deque_test_counted(i));
+		for(int i = 0; i < off; ++i)
+			b.pop_front();
+		for(int i = 0; i < 3; ++i)
+			c.push_back(deque_test_counted(-2));
+		deque_test_counted::copies() = 0;
+		a.append(std::move(b));
+		c.prepend(std::move(a));
+		counted d = c.split_at(150 + off);
+		c.splice(c.begin() + 70, std::move(d));
+		assert(deque_test_counted::copies() == 0);
+		assert(c.size() == 320);
+		assert(c[69].v == 69);
+		assert(c[70].v == 150 + off);
+		assert(c[319].v == 149 + off);
+		}
+	}
+
+	{
+	// rotate(k)
+	const int sizes[] = {1, 7, 10, 40, 100, 103, 256, 384, 390};
+	for(int n = 0; n < 9; ++n){
+		for(int k = 0; k <= sizes[n] + 1; ++k){
+			for(int lead = 0; lead < 3; ++lead){
+				Deque a;
+				for(int i = 0; i < lead * 4; ++i) // vary the alignment of the front
+					a.push_front(-1);
+				for(int i = 0; i < sizes[n]; ++i)
+					a.push_back(i);
+				for(int i = 0; i < lead * 4; ++i)
+					a.pop_front();
+
+				a.rotate(k);
+				assert(a.size() == (size_type)sizes[n]);
+				for(int i = 0; i < sizes[n]; ++i)
+					assert(a[i] == (i + k) % sizes[n]);
+				}
+			}
+		}
+
+	Deque b;
+	b.rotate(3);
+	assert(b.empty());
+
+	// rotating moves the elements it carries from one end to the other
+	::dt::prog::deque::Deque<deque_test_counted> c;
+	for(int i = 0; i < 103; ++i)
+		c.push_back(deque_test_counted(i));
+	deque_test_counted::copies() = 0;
+	c.rotate(10);
+	c.rotate(90);
+	assert(deque_test_counted::copies() == 0);
+	for(int i = 0; i < 103; ++i)
+		assert(c[i].v == (i + 100) % 103);
+	}
+
+	{
+	// a FIFO drifting towards the back reuses the blocks it leaves behind
+	Deque a;
+	for(int i = 0; i < 100; ++i)
+		a.push_back(i);
+	for(int i = 100; i < 100000; ++i){
+		a.push_back(i);
+		a.pop_front();
+		assert(a.front() == i - 99);
+		}
+	assert(a.size() == 100);
+	assert(a.back() == 99999);
+
+	Deque b;
+	for(int i = 0; i < 100000; ++i){
+		b.push_front(i);
+		b.pop_back();
+		}
+	assert(b.empty());
+	}
+
+	{
+	// pushes move the outer array a few slots at a time; every other operation
+	// in between sees the same elements as a vector
+	deque_test_migration<Deque>();
+	deque_test_migration< ::dt::prog::deque::Deque<deque_test_wide> >();
+	}
+
+	{
+	// ==, < across deques whose blocks do not line up
+	for(int lead = 0; lead < 300; lead += 37){
+		Deque a;
+		Deque b;
+		for(int i = 0; i < lead; ++i)
+			b.push_front(0);
+		for(int i = 0; i < 1000; ++i){
+			a.push_back(i % 97);
+			b.push_back(i % 97);
+			}
+		for(int i = 0; i < lead; ++i)
+			b.pop_front();
+		assert(a == b);
+		assert(!(a < b));
+		assert(!(b < a));
+
+		b[731] = 1000;
+		assert(a != b);
+		assert(a < b);
+		assert(!(b < a));
+		assert(b > a);
+
+		b[731] = a[731];
+		b.push_back(0);
+		assert(a != b);
+		assert(a < b);
+		b.pop_back();
+		b[0] = -1;
+		assert(b < a);
+		}
+	}
+
+	{
+		// insert and erase in the middle keep the order of a vector
+		Deque a;
+		std::vector<int> v;
+		for(int i = 0; i < 3000; ++i){
+			int k = (i * 7919) % (int)(v.size() + 1);
+			a.insert(a.begin() + k, i);
+			v.insert(v.begin() + k, i);
+			}
+		for(int i = 0; i < 1000; ++i){
+			int k = (i * 104729) % (int)v.size();
+			a.erase(a.begin() + k);
+			v.erase(v.begin() + k);
+			}
+		assert(a.size() == v.size());
+		for(size_type i = 0; i < v.size(); ++i)
+			assert(a[i] == v[i]);
+		}
+
+	{
+		// range erase of a prefix, a suffix and runs on both sides of the middle
+		Deque a;
+		std::vector<int> v;
+		for(int i = 0; i < 5000; ++i){
+			a.push_back(i);
+			v.push_back(i);
+			}
+		int ranges[][2] = {{0, 0}, {0, 700}, {4000, 4300}, {10, 1000}, {2000, 2900}, {1000, 1001}};
+		for(int r = 0; r < 6; ++r){
+			typename Deque::iterator i = a.erase(a.begin() + ranges[r][0], a.begin() + ranges[r][1]);
+			v.erase(v.begin() + ranges[r][0], v.begin() + ranges[r][1]);
+			assert(i - a.begin() == ranges[r][0]);
+			assert(a.size() == v.size());
+			for(size_type j = 0; j < v.size(); ++j)
+				assert(a[j] == v[j]);
+			}
+		a.erase(a.begin() + 100, a.end());
+		assert(a.size() == 100 && a.back() == v[99]);
+		a.erase(a.begin(), a.end());
+		assert(a.empty());
+		a.push_back(3);
+		a.push_front(2);
+		assert(a.front() == 2 && a.back() == 3);
+		}
+
+	{
+		// reserve_back, reserve_front and reserve leave room for pushes without growth
+		Deque a;
+		a.push_back(0);
+		a.reserve_back(10000);
+		size_type c = a.capacity();
+		for(int i = 1; i <= 10000; ++i)
+			a.push_back(i);
+		assert(a.capacity() == c);
+		a.reserve_front(5000);
+		c = a.capacity();
+		for(int i = 1; i <= 5000; ++i)
+			a.push_front(-i);
+		assert(a.capacity() == c);
+		assert(a.size() == 15001 && a.front() == -5000 && a.back() == 10000);
+		for(size_type i = 0; i < a.size(); ++i)
+			assert(a[i] == (int)i - 5000);
+		a.reserve(a.size() / 2);
+		assert(a.capacity() == c);
+		a.reserve(a.size() + 1000);
+		c = a.capacity();
+		for(int i = 0; i < 1000; ++i)
+			a.push_back(i);
+		assert(a.capacity() == c);
+		}
+
+	{
+		// append_n and assign
+		Deque a;
+		int k = 0;
+		a.push_back(-1);
+		a.append_n(3000, [&] () { return k++; });
+		assert(a.size() == 3001 && a.front() == -1);
+		for(int i = 0; i < 3000; ++i)
+			assert(a[i + 1] == i);
+		a.append_n(0, [&] () { return k++; });
+		assert(a.size() == 3001 && k == 3000);
+
+		std::vector<int> v(2500);
+		for(int i = 0; i < 2500; ++i)
+			v[i] = 7 * i;
+		a.assign(v.begin(), v.end());
+		assert(a.size() == 2500);
+		for(int i = 0; i < 2500; ++i)
+			assert(a[i] == 7 * i);
+		std::istringstream in("4 5 6");
+		a.assign(std::istream_iterator<int>(in), std::istream_iterator<int>());
+		assert(a.size() == 3 && a[0] == 4 && a[2] == 6);
+		Deque b(a);
+		assert(b == a);
+		}
+
+	{
+		// resize fills runs that start partway into a block and span many blocks
+		Deque a(1000, -1);
+		a.push_front(5);
+		a.resize(5000, 7);
+		assert(a.size() == 5000 && a.front() == 5);
+		for(size_type i = 1; i < 1001; ++i)
+			assert(a[i] == -1);
+		for(size_type i = 1001; i < 5000; ++i)
+			assert(a[i] == 7);
+		a.resize(9000);
+		for(size_type i = 5000; i < 9000; ++i)
+			assert(a[i] == 0);
+		a.resize(3);
+		a.resize(300, a[1]);
+		for(size_type i = 1; i < 300; ++i)
+			assert(a[i] == -1);
+		}
+
+	{
+		// pop_front_n, pop_back_n, discard_front and drain across block boundaries
+		Deque a;
+		for(int i = 0; i < 1000; ++i)
+			a.push_back(i);
+		std::vector<int> v;
+		a.pop_front_n(300, std::back_inserter(v));
+		assert(v.size() == 300 && v[0] == 0 && v[299] == 299);
+		assert(a.size() == 700 && a.front() == 300);
+		v.clear();
+		a.pop_back_n(200, std::back_inserter(v));
+		assert(v.size() == 200 && v[0] == 800 && v[199] == 999);
+		assert(a.size() == 500 && a.back() == 799);
+		a.discard_front(150);
+		assert(a.size() == 350 && a.front() == 450);
+		std::vector<int> w;
+		size_type segments = 0;
+		a.drain([&] (int* p, size_type k) {
+			w.insert(w.end(), p, p + k);
+			++segments;});
+		assert(a.empty() && w.size() == 350 && segments > 1);
+		for(int i = 0; i < 350; ++i)
+			assert(w[i] == 450 + i);
+		a.push_back(1);
+		a.push_front(0);
+		v.clear();
+		a.pop_front_n(10, std::back_inserter(v));
+		assert(a.empty() && v.size() == 2 && v[1] == 1);
+		a.discard_front(5);
+		assert(a.empty());
+		}
+
+	{
+		// the batch pops destroy what they move from
+		typedef ::dt::prog::deque::Deque<std::string> strings;
+		strings a;
+		for(int i = 0; i < 600; ++i)
+			a.push_back(std::string(40, (char)('a' + i % 26)));
+		std::vector<std::string> v;
+		a.pop_front_n(250, std::back_inserter(v));
+		a.pop_back_n(50, std::back_inserter(v));
+		a.discard_front(100);
+		assert(a.size() == 200 && v.size() == 300);
+		assert(v[0] == std::string(40, 'a') && v[299] == std::string(40, (char)('a' + 599 % 26)));
+		a.drain([&] (std::string* p, size_type k) {
+			for(size_type j = 0; j < k; ++j)
+				v.push_back(std::move(p[j]));});
+		assert(a.empty() && v.size() == 500);
+		}
+
 } // deque_test
 
 } // deque
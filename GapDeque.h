@@ -0,0 +1,488 @@
+// ----------------------
+// prog/deque/GapDeque.h
+// Tj Wrenn
+// ----------------------
+
+#ifndef GapDeque_h
+#define GapDeque_h
+
+// --------
+// includes
+// --------
+
+#include <cassert> // assert
+#include <iterator> // random_access_iterator_tag
+#include <memory> // allocator
+#include <stdexcept> // out_of_range
+#include <type_traits> // conditional
+#include <utility> // move
+
+#include "Deque.h"
+
+// ----------
+// namespaces
+// ----------
+
+namespace dt{
+namespace prog{
+namespace deque{
+
+// --------
+// GapDeque
+// --------
+
+/**
+* A sequence with a cursor, for inserting and deleting repeatedly at one
+* position, as a text buffer does.
+*
+* The elements are held by two Deques, the ones before the gap and the ones
+* after it, so the gap is the free space at the back of the first and the
+* front of the second.  Inserting at the gap is a push_back on the first, and
+* deleting on either side of it a pop, all O(1).  Moving the cursor only
+* records the new position; the gap follows the next time the cursor inserts
+* or deletes.  operator[] and the iterators read across the gap as if it
+* were not there.
+*/
+template < typename T, typename A = std::allocator<T> >
+class GapDeque{
+public:
+// --------
+// typedefs
+// --------
+
+typedef Deque<T, A> deque_type;
+
+typedef typename deque_type::allocator_type allocator_type;
+typedef typename deque_type::value_type value_type;
+
+typedef typename deque_type::size_type size_type;
+typedef typename deque_type::difference_type difference_type;
+
+typedef typename deque_type::pointer pointer;
+typedef typename deque_type::const_pointer const_pointer;
+
+typedef typename deque_type::reference reference;
+typedef typename deque_type::const_reference const_reference;
+
+// -------------
+// BasicIterator
+// -------------
+
+/**
+* a random access iterator by index, reading across the gap;
+* iterator and const_iterator are its two instances
+*/
+template <bool Const>
+class BasicIterator{
+	friend class GapDeque;
+	friend class BasicIterator<!Const>;
+
+public:
+	typedef std::random_access_iterator_tag iterator_category;
+	typedef typename GapDeque::value_type value_type;
+	typedef typename GapDeque::difference_type difference_type;
+	typedef typename std::conditional<Const, typename GapDeque::const_pointer, typename GapDeque::pointer>::type pointer;
+	typedef typename std::conditional<Const, typename GapDeque::const_reference, typename GapDeque::reference>::type reference;
+
+private:
+	typedef typename std::conditional<Const, const GapDeque, GapDeque>::type container;
+
+	container* thedeque;
+	difference_type cur;
+
+public:
+	BasicIterator ()
+		: thedeque(NULL), cur(0) {}
+
+	/**
+	* an iterator converts to a const_iterator
+	*/
+	BasicIterator (const BasicIterator<false>& that)
+		: thedeque(that.thedeque), cur(that.cur) {}
+
+	reference operator * ()const {
+		return (*thedeque)[cur];}
+
+	pointer operator -> ()const {
+		return &**this;}
+
+	reference operator [] (difference_type i)const {
+		return (*thedeque)[cur + i];}
+
+	BasicIterator& operator ++ (){
+		++cur;
+		return *this;}
+
+	BasicIterator operator ++ (int){
+		BasicIterator x = *this;
+		++cur;
+		return x;}
+
+	BasicIterator& operator -- (){
+		--cur;
+		return *this;}
+
+	BasicIterator operator -- (int){
+		BasicIterator x = *this;
+		--cur;
+		return x;}
+
+	BasicIterator& operator += (difference_type v){
+		cur += v;
+		return *this;}
+
+	BasicIterator& operator -= (difference_type v){
+		cur -= v;
+		return *this;}
+
+	BasicIterator operator + (difference_type v)const {
+		BasicIterator r = *this;
+		return r += v;}
+
+	BasicIterator operator - (difference_type v)const {
+		BasicIterator r = *this;
+		return r -= v;}
+
+	difference_type operator - (const BasicIterator& that)const {
+		return cur - that.cur;}
+
+	bool operator == (const BasicIterator& that)const {
+		return (cur == that.cur) && (thedeque == that.thedeque);}
+
+	bool operator != (const BasicIterator& that)const {
+		return !(*this == that);}
+
+	bool operator < (const BasicIterator& that)const {
+		return cur < that.cur;}
+
+	bool operator > (const BasicIterator& that)const {
+		return that < *this;}
+
+	bool operator <= (const BasicIterator& that)const {
+		return !(that < *this);}
+
+	bool operator >= (const BasicIterator& that)const {
+		return !(*this < that);}};
+
+typedef BasicIterator<false> iterator;
+typedef BasicIterator<true> const_iterator;
+
+private:
+// -------------
+// static consts
+// -------------
+
+/**
+* distance past which the gap moves by whole blocks
+*/
+static const size_type splice_distance = 4096;
+
+// ----
+// data
+// ----
+
+/**
+* the elements before the gap, and the ones after it
+*/
+deque_type before;
+deque_type after;
+
+/**
+* where the gap should be; it is moved there by the next edit
+*/
+size_type c;
+
+// -----
+// valid
+// -----
+
+/**
+* O(1)
+* M(1)
+* @return true if gap deque is in valid state
+*/
+bool valid ()const {
+	return c <= size();}
+
+/**
+* moves the gap to the cursor: one element at a time over a short distance,
+* else by split_at(), which moves whole blocks, then prepend() or append() onto
+* the other half.  those move whole blocks only when the two halves meet at
+* the same offset into a block, and nothing keeps them there, since edits at
+* the gap shift the end of before, so in general they move the smaller side
+* element by element.
+* O(d) if d <= splice_distance, else O(n / block_size + block_size + min(d, m)),
+* where d is the distance the gap moves and m the size of the half it joins
+* M(1)
+*/
+void follow (){
+	if(before.size() > c + splice_distance)
+		after.prepend(before.split_at(c));
+	else if(c > before.size() + splice_distance){
+		deque_type rest = after.split_at(c - before.size());
+		before.append(std::move(after));
+		after.swap(rest);}
+	while(before.size() > c){
+		after.push_front(before.back());
+		before.pop_back();}
+	while(before.size() < c){
+		before.push_back(after.front());
+		after.pop_front();}}
+
+public:
+// --------
+// GapDeque
+// --------
+
+/**
+* O(1)
+* M(block_size)
+* @param a allocator
+*/
+explicit GapDeque (const allocator_type& a = allocator_type())
+	: before(a), after(a), c(0) {
+		assert(valid());}
+
+// -----------
+// operator []
+// -----------
+
+/**
+* O(1)
+* M(1)
+* @param index element index
+* @return reference to value at the index'th position
+*/
+reference operator [] (size_type index){
+	return (index < before.size()) ? before[index] : after[index - before.size()];}
+
+/**
+* O(1)
+* M(1)
+* @param index element index
+* @return constant reference to value at the index'th position
+*/
+const_reference operator [] (size_type index)const {
+	return (index < before.size()) ? before[index] : after[index - before.size()];}
+
+// --
+// at
+// --
+
+/**
+* O(1)
+* M(1)
+* @param index element index
+* @throw std::out_of_range
+* @return reference to value at the index'th position
+*/
+reference at (size_type index){
+	if(index >= size())
+		throw std::out_of_range("deque [] access out of range");
+	return (*this)[index];}
+
+/**
+* O(1)
+* M(1)
+* @param index element index
+* @throw std::out_of_range
+* @return constant reference to value at the index'th position
+*/
+const_reference at (size_type index)const {
+	return const_cast<GapDeque*>(this)->at(index);}
+
+// -----------
+// front, back
+// -----------
+
+reference front (){
+	return (*this)[0];}
+
+const_reference front ()const {
+	return (*this)[0];}
+
+reference back (){
+	return (*this)[size() - 1];}
+
+const_reference back ()const {
+	return (*this)[size() - 1];}
+
+// ----------
+// begin, end
+// ----------
+
+iterator begin (){
+	iterator i;
+	i.thedeque = this;
+	return i;}
+
+const_iterator begin ()const {
+	const_iterator i;
+	i.thedeque = this;
+	return i;}
+
+iterator end (){
+	return begin() + size();}
+
+const_iterator end ()const {
+	return begin() + size();}
+
+// ------
+// cursor
+// ------
+
+/**
+* O(1)
+* M(1)
+* @return the cursor's position; inserts go before the element at it
+*/
+size_type cursor ()const {
+	return c;}
+
+/**
+* moves the cursor; the gap follows at the next insert or erase
+* O(1)
+* M(1)
+* @param index new position, at most size()
+* @throw std::out_of_range
+*/
+void set_cursor (size_type index){
+	if(index > size())
+		throw std::out_of_range("deque cursor out of range");
+	c = index;}
+
+// ------
+// insert
+// ------
+
+/**
+* inserts v at the cursor and moves the cursor past it
+* O(1), plus follow() to move the gap to the cursor
+* M(1)
+* @param v value to insert
+*/
+void insert (const_reference v){
+	follow();
+	before.push_back(v);
+	++c;
+	assert(valid());}
+
+/**
+* moves the cursor to index, then inserts v there
+* O(1), plus follow() to move the gap to index
+* M(1)
+* @param index position of the new element, at most size()
+* @param v value to insert
+*/
+void insert (size_type index, const_reference v){
+	set_cursor(index);
+	insert(v);}
+
+// -------------------------
+// erase_before, erase_after
+// -------------------------
+
+/**
+* erases the element before the cursor, as backspace does
+* O(1), plus follow() to move the gap to the cursor
+* M(1)
+*/
+void erase_before (){
+	assert(c > 0);
+	follow();
+	before.pop_back();
+	--c;
+	assert(valid());}
+
+/**
+* erases the element at the cursor, as delete does
+* O(1), plus follow() to move the gap to the cursor
+* M(1)
+*/
+void erase_after (){
+	assert(c < size());
+	follow();
+	after.pop_front();
+	assert(valid());}
+
+// ---------------------
+// push_back, push_front
+// ---------------------
+
+/**
+* O(1)
+* M(1)
+* @param v value to append
+*/
+void push_back (const_reference v){
+	after.push_back(v);}
+
+/**
+* keeps the cursor at the same element
+* O(1)
+* M(1)
+* @param v value to prepend
+*/
+void push_front (const_reference v){
+	before.push_front(v);
+	++c;}
+
+// -------------------
+// pop_back, pop_front
+// -------------------
+
+/**
+* O(1)
+* M(1)
+*/
+void pop_back (){
+	assert(!empty());
+	if(after.empty())
+		before.pop_back();
+	else
+		after.pop_back();
+	if(c > size())
+		c = size();}
+
+/**
+* keeps the cursor at the same element, or at 0
+* O(1)
+* M(1)
+*/
+void pop_front (){
+	assert(!empty());
+	if(before.empty())
+		after.pop_front();
+	else
+		before.pop_front();
+	if(c > 0)
+		--c;}
+
+// -----
+// clear
+// -----
+
+void clear (){
+	before.clear();
+	after.clear();
+	c = 0;}
+
+// -----
+// empty
+// -----
+
+bool empty ()const {
+	return before.empty() && after.empty();}
+
+// ----
+// size
+// ----
+
+size_type size ()const {
+	return before.size() + after.size();}};
+
+} // deque
+} // prog
+} // dt
+
+#endif // GapDeque_h
@@ -0,0 +1,114 @@
+// -------------------------
+// prog/deque/GapDequeTest.h
+// Tj Wrenn
+// -------------------------
+
+#ifndef GapDequeTest_h
+#define GapDequeTest_h
+
+// --------
+// includes
+// --------
+
+#include <algorithm> // find, reverse
+#include <cassert>   // assert
+#include <cstdlib>   // rand, srand
+#include <stdexcept> // out_of_range
+#include <vector>    // vector
+
+// ----------
+// namespaces
+// ----------
+
+namespace dt {
+namespace prog  {
+namespace deque  {
+
+// --------------
+// gap_deque_test
+// --------------
+
+/**
+ * function gap_deque_test is a tester of class GapDeque, instantiated with
+ * an integral element type
+ */
+template <typename GapDeque>
+void gap_deque_test () {
+	typedef typename GapDeque::value_type value_type;
+	typedef typename GapDeque::size_type  size_type;
+
+	{
+	// typing at a cursor
+	GapDeque a;
+	for(int i = 0; i < 10; ++i)
+		a.push_back(i);
+	a.set_cursor(5);
+	a.insert(100);
+	a.insert(101);
+	assert(a.cursor() == 7);
+	assert(a.size() == 12);
+	assert(a[4] == 4 && a[5] == 100 && a[6] == 101 && a[7] == 5);
+	a.erase_before();
+	a.erase_after();
+	assert(a[5] == 100 && a[6] == 6);
+	a.push_front(-1);
+	assert(a.cursor() == 7 && a[7] == 6);
+	bool thrown = false;
+	try {
+		a.set_cursor(a.size() + 1);}
+	catch(std::out_of_range&) {
+		thrown = true;}
+	assert(thrown);
+	}
+
+	{
+	// iterators read across the gap
+	GapDeque a;
+	for(int i = 0; i < 1000; ++i)
+		a.push_back(i);
+	a.insert(500, -7);
+	assert(std::find(a.begin(), a.end(), -7) - a.begin() == 500);
+	std::reverse(a.begin(), a.end());
+	assert(a[500] == -7 && a[0] == 999);
+	const GapDeque& b = a;
+	typename GapDeque::const_iterator i = b.begin();
+	assert(i[1000] == 0);
+	assert(b.end() - b.begin() == 1001);
+	}
+
+	{
+	// random edits agree with a vector
+	std::srand(23);
+	GapDeque a;
+	std::vector<value_type> v;
+	size_type c = 0;
+	for(int r = 0; r < 20000; ++r){
+		int op = std::rand() % 10;
+		if(op == 0){
+			c = std::rand() % (v.size() + 1);
+			a.set_cursor(c);}
+		else if(op < 7){
+			a.insert(r);
+			v.insert(v.begin() + c++, r);}
+		else if(op == 7 && c > 0){
+			a.erase_before();
+			v.erase(v.begin() + --c);}
+		else if(op == 8 && c < v.size()){
+			a.erase_after();
+			v.erase(v.begin() + c);}
+		else if(op == 9 && !v.empty()){
+			a.pop_front();
+			v.erase(v.begin());
+			if(c > 0) --c;}
+		assert(a.cursor() == c);}
+	assert(a.size() == v.size());
+	for(size_type i = 0; i < v.size(); ++i)
+		assert(a[i] == v[i]);
+	}
+} // gap_deque_test
+
+} // deque
+} // prog
+} // dt
+
+#endif // GapDequeTest_h
@@ -0,0 +1,254 @@
+// ------------------------------
+// prog/deque/HugePageAllocator.h
+// Tj Wrenn
+// ------------------------------
+
+#ifndef HugePageAllocator_h
+#define HugePageAllocator_h
+
+// --------
+// includes
+// --------
+
+#include <cstddef> // size_t
+#include <cstdint> // uintptr_t
+#include <new> // operator new, operator delete, bad_alloc
+#include <vector> // vector
+
+#ifdef __linux__
+#include <sys/mman.h> // mmap, munmap, madvise, mlock, munlock
+#endif
+
+#include "BlockCache.h"
+
+// ----------
+// namespaces
+// ----------
+
+namespace dt{
+namespace prog{
+namespace deque{
+
+// -------------
+// HugePageArena
+// -------------
+
+/**
+* One large anonymous mapping, aligned to and advised into 2 MB huge pages
+* (MADV_HUGEPAGE), carved into equally sized blocks for the Deques that
+* allocate through HugePageAllocator.  Consecutive blocks share a huge page,
+* so walking a deque hops between far fewer TLB entries than when every
+* block is a separate heap allocation.
+*
+* With prefault, every page is touched when the arena is made, and with lock
+* the mapping is also mlock()ed, so a push never takes a page fault.  locked()
+* tells whether mlock succeeded, which RLIMIT_MEMLOCK may prevent.
+*
+* Blocks are taken from the mapping in order and freed blocks are reused
+* first.  Once the mapping is used up, blocks come from operator new, as
+* they do without Linux.
+*/
+class HugePageArena{
+public:
+// --------
+// typedefs
+// --------
+
+typedef std::size_t size_type;
+
+/**
+* blocks of the mapping can only go back to it
+*/
+static const bool heap_blocks = false;
+
+static const size_type huge_page = (size_type)2 << 20;
+static const size_type page = 4096;
+
+/**
+* flags for the constructor
+*/
+enum {prefault = 1, lock = 2};
+
+private:
+// ----
+// data
+// ----
+
+char* base;
+size_type bytes;
+size_type used;
+
+/**
+* size in bytes of the blocks carved, or 0 before the first one
+*/
+size_type block;
+
+std::vector<void*> blocks;
+bool isLocked;
+
+// -------
+// copying
+// -------
+
+HugePageArena (const HugePageArena&);
+HugePageArena& operator = (const HugePageArena&);
+
+public:
+// -------------
+// HugePageArena
+// -------------
+
+/**
+* O(n / page) with prefault, else O(1), where n is the size
+* M(n)
+* @param size bytes to map, rounded up to a whole number of huge pages
+* @param flags prefault, lock, or both
+*/
+explicit HugePageArena (size_type size, int flags = 0)
+	: base(NULL), bytes(0), used(0), block(0), isLocked(false) {
+#ifdef __linux__
+	size = (size + huge_page - 1) / huge_page * huge_page;
+	if(size == 0)
+		return;
+	void* p = mmap(NULL, size + huge_page, PROT_READ | PROT_WRITE, MAP_PRIVATE | MAP_ANONYMOUS, -1, 0);
+	if(p == MAP_FAILED)
+		throw std::bad_alloc();
+	char* q = static_cast<char*>(p);
+	size_type head = (huge_page - (std::uintptr_t)q % huge_page) % huge_page;
+	if(head)
+		munmap(q, head);
+	if(huge_page - head)
+		munmap(q + head + size, huge_page - head);
+	base = q + head;
+	bytes = size;
+#ifdef MADV_HUGEPAGE
+	madvise(base, bytes, MADV_HUGEPAGE);
+#endif
+	if(flags & (prefault | lock))
+		for(size_type i = 0; i < bytes; i += page)
+			base[i] = 0;
+	if(flags & lock)
+		isLocked = (mlock(base, bytes) == 0);
+#else
+	(void)size;
+	(void)flags;
+#endif
+	}
+
+/**
+* O(n), where n is the number of free blocks from operator new
+* M(1)
+*/
+~HugePageArena (){
+	for(size_type i = 0; i < blocks.size(); ++i)
+		if(!contains(blocks[i]))
+			::operator delete(blocks[i]);
+#ifdef __linux__
+	if(base){
+		if(isLocked)
+			munlock(base, bytes);
+		munmap(base, bytes);}
+#endif
+	}
+
+// --------
+// contains
+// --------
+
+/**
+* O(1)
+* M(1)
+* @param p a pointer
+* @return true if p points into the mapping
+*/
+bool contains (const void* p)const {
+	const char* q = static_cast<const char*>(p);
+	return base && q >= base && q < base + bytes;}
+
+// ----
+// take
+// ----
+
+/**
+* O(1)
+* M(n)
+* @param n size in bytes
+* @return a free block of n bytes, the next one in the mapping, or a new one
+*/
+void* take (size_type n){
+	if(!block)
+		block = n;
+	if(n == block){
+		if(!blocks.empty()){
+			void* p = blocks.back();
+			blocks.pop_back();
+			return p;}
+		if(bytes - used >= n){
+			void* p = base + used;
+			used += n;
+			return p;}}
+	return ::operator new(n);}
+
+// ----
+// give
+// ----
+
+/**
+* O(1)
+* M(1)
+* @param p a block from take()
+* @param n its size in bytes
+*/
+void give (void* p, size_type n){
+	if(n == block)
+		blocks.push_back(p);
+	else
+		::operator delete(p);}
+
+// ----
+// size
+// ----
+
+/**
+* O(1)
+* M(1)
+* @return bytes mapped, 0 if the mapping could not be made
+*/
+size_type size ()const {
+	return bytes;}
+
+/**
+* O(1)
+* M(1)
+* @return bytes of the mapping handed out as blocks so far
+*/
+size_type in_use ()const {
+	return used;}
+
+/**
+* O(1)
+* M(1)
+* @return true if the mapping is locked in memory
+*/
+bool locked ()const {
+	return isLocked;}};
+
+// -----------------
+// HugePageAllocator
+// -----------------
+
+/**
+* an allocator drawing Deque blocks from a HugePageArena (see CachedAllocator), e.g.
+*
+*     HugePageArena arena(1 << 30, HugePageArena::prefault);
+*     HugePageAllocator<int> h(&arena);
+*     Deque<int, HugePageAllocator<int> > x(h);
+*/
+template <typename T>
+using HugePageAllocator = CachedAllocator<T, HugePageArena>;
+
+} // deque
+} // prog
+} // dt
+
+#endif // HugePageAllocator_h
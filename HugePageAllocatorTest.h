@@ -0,0 +1,92 @@
+// ----------------------------------
+// prog/deque/HugePageAllocatorTest.h
+// Tj Wrenn
+// ----------------------------------
+
+#ifndef HugePageAllocatorTest_h
+#define HugePageAllocatorTest_h
+
+// --------
+// includes
+// --------
+
+#include <cassert> // assert
+#include <utility> // move
+
+#include "HugePageAllocator.h"
+
+// ----------
+// namespaces
+// ----------
+
+namespace dt {
+namespace prog  {
+namespace deque  {
+
+// ------------------------
+// huge_page_allocator_test
+// ------------------------
+
+/**
+ * function huge_page_allocator_test is a tester of HugePageArena and
+ * HugePageAllocator, instantiated with a Deque of an integral type over a
+ * HugePageAllocator
+ */
+template <typename Deque>
+void huge_page_allocator_test () {
+	typedef typename Deque::value_type     value_type;
+	typedef typename Deque::size_type      size_type;
+	typedef typename Deque::allocator_type allocator_type;
+
+	{
+	HugePageArena arena(1, HugePageArena::prefault);
+#ifdef __linux__
+	assert(arena.size() == HugePageArena::huge_page);
+#endif
+	allocator_type h(&arena);
+	{
+	Deque x(h);
+	for(int i = 0; i < 10000; ++i)
+		x.push_back(value_type(i));
+	for(size_type i = 0; i < x.size(); i += x.segment_length(i))
+		assert(arena.size() == 0 || arena.contains(&x[i]));
+	for(int i = 0; i < 10000; ++i)
+		assert(x[i] == value_type(i));
+	}
+	size_type used = arena.in_use();
+	{
+	Deque y(h);
+	for(int i = 0; i < 10000; ++i)
+		y.push_front(value_type(i));
+	Deque z(h);
+	z.append(std::move(y));
+	assert(z.size() == 10000 && y.empty());
+	assert(z.front() == value_type(9999) && z.back() == value_type(0));
+	}
+	assert(arena.in_use() < 2 * used); // x's blocks were reused
+	}
+
+	{
+	HugePageArena arena(1);
+	allocator_type h(&arena);
+	Deque x(h);
+	size_type n = 2 * HugePageArena::huge_page / sizeof(value_type);
+	for(size_type i = 0; i < n; ++i)
+		x.push_back(value_type(i));
+	assert(arena.in_use() == arena.size());
+	assert(x[0] == value_type(0) && x[n - 1] == value_type(n - 1));
+	}
+
+	{
+	HugePageArena a(1);
+	HugePageArena b(1);
+	assert(allocator_type(&a) == allocator_type(&a));
+	assert(allocator_type(&a) != allocator_type(&b));
+	}
+} // huge_page_allocator_test
+
+} // deque
+} // prog
+} // dt
+
+#endif // HugePageAllocatorTest_h
@@ -0,0 +1,398 @@
+// ---------------------------
+// prog/deque/SequencedDeque.h
+// Tj Wrenn
+// ---------------------------
+
+#ifndef SequencedDeque_h
+#define SequencedDeque_h
+
+// --------
+// includes
+// --------
+
+#include <cassert> // assert
+#include <memory> // allocator
+#include <stdexcept> // out_of_range
+#include <type_traits> // is_trivially_destructible
+
+// ----------
+// namespaces
+// ----------
+
+namespace dt{
+namespace prog{
+namespace deque{
+
+// --------------
+// SequencedDeque
+// --------------
+
+/**
+* A FIFO whose elements keep the absolute sequence number they were pushed
+* with, so replay lookups need no offset arithmetic after pop_front.
+*
+* Sequence number n always lives in slot n % block_size of the block for
+* n / block_size, and blocks sit in a circular outer array.  at_seq() is one
+* subtraction, a mask and two loads; popping or trimming past the end of a
+* block hands the whole block back (one spare is kept for reuse, so a steady
+* FIFO does not allocate).
+*/
+template < typename T, typename A = std::allocator<T> >
+class SequencedDeque{
+public:
+// --------
+// typedefs
+// --------
+
+typedef A allocator_type;
+typedef typename allocator_type::value_type value_type;
+
+typedef typename allocator_type::size_type size_type;
+typedef typename allocator_type::difference_type difference_type;
+
+typedef typename allocator_type::pointer pointer;
+typedef typename allocator_type::const_pointer const_pointer;
+
+typedef typename allocator_type::reference reference;
+typedef typename allocator_type::const_reference const_reference;
+
+typedef unsigned long long sequence_type;
+
+private:
+// -------------
+// static consts
+// -------------
+
+/**
+* number of elements in a block, a power of two
+*/
+static const size_type block_size = 64;
+
+typedef typename A::template rebind<pointer>::other outer_allocator_type;
+
+// ----
+// data
+// ----
+
+allocator_type a;
+
+/**
+* circular array of blocks; outer[h] holds sequence block base / block_size
+*/
+pointer* outer;
+
+/**
+* number of elements of the outer array, a power of two
+*/
+size_type outerSize;
+
+/**
+* index into outer of the first block in use
+*/
+size_type h;
+
+/**
+* a released block kept for the next push_back, or NULL
+*/
+pointer spare;
+
+/**
+* sequence number of the first element
+*/
+sequence_type base;
+
+/**
+* sequence number one past the last element
+*/
+sequence_type next;
+
+// -----
+// valid
+// -----
+
+/**
+* O(1)
+* M(1)
+* @return true if deque is in valid state
+*/
+bool valid ()const {
+	return (outer != NULL && outerSize > 0 && !(outerSize & (outerSize - 1)) && base <= next && usedBlocks() <= outerSize);}
+
+/**
+* O(1)
+* M(1)
+* @return number of blocks spanned by [base, next), counting base's block even when empty
+*/
+size_type usedBlocks ()const {
+	return (size_type)((next + block_size - 1) / block_size - base / block_size);}
+
+/**
+* O(1)
+* M(1)
+* @param n a sequence number in [base, next)
+* @return pointer to the slot holding sequence number n
+*/
+pointer slot (sequence_type n)const {
+	size_type k = (size_type)(n / block_size - base / block_size);
+	return outer[(h + k) & (outerSize - 1)] + (n % block_size);}
+
+/**
+* O(1)
+* M(block_size)
+* @return an unused block, the spare one if there is one
+*/
+pointer takeBlock (){
+	pointer p = spare;
+	spare = NULL;
+	return (p != NULL) ? p : a.allocate(block_size);}
+
+/**
+* O(1)
+* M(1)
+* @param p a block no longer holding elements
+*/
+void giveBlock (pointer p){
+	if(spare == NULL)
+		spare = p;
+	else
+		a.deallocate(p, block_size);}
+
+/**
+* doubles the outer array, unrolling the circle to start at index 0
+* O(outerSize)
+* M(outerSize)
+*/
+void grow (){
+	size_type u = usedBlocks();
+	size_type n = outerSize * 2;
+	outer_allocator_type x(a);
+	pointer* newOuter = x.allocate(n);
+	for(size_type i = 0; i < u; ++i)
+		newOuter[i] = outer[(h + i) & (outerSize - 1)];
+	x.deallocate(outer, outerSize);
+	outer = newOuter;
+	outerSize = n;
+	h = 0;}
+
+/**
+* moves base to n, which must be in [base, next], releasing every block left behind
+* O(blocks released), plus O(n - base) destructor calls unless T is trivially destructible
+* M(1)
+* @param n new first sequence number
+*/
+void advance (sequence_type n){
+	if(!std::is_trivially_destructible<T>::value)
+		for(sequence_type i = base; i < n; ++i)
+			a.destroy(slot(i));
+	size_type k = (size_type)(n / block_size - base / block_size);
+	for(size_type i = 0; i < k; ++i){
+		giveBlock(outer[h]);
+		h = (h + 1) & (outerSize - 1);}
+	base = n;}
+
+// -------
+// copying
+// -------
+
+SequencedDeque (const SequencedDeque&);
+SequencedDeque& operator = (const SequencedDeque&);
+
+public:
+// --------------
+// SequencedDeque
+// --------------
+
+/**
+* O(1)
+* M(block_size)
+* @param first sequence number the first pushed element gets
+* @param a allocator
+*/
+explicit SequencedDeque (sequence_type first = 0, const allocator_type& a = allocator_type())
+	: a(a), outerSize(4), h(0), spare(NULL), base(first), next(first) {
+		outer_allocator_type x(this->a);
+		outer = x.allocate(outerSize);
+		if(first % block_size)
+			outer[0] = takeBlock();
+		assert(valid());}
+
+/**
+* O(n + outerSize)
+* M(1)
+*/
+~SequencedDeque (){
+	advance(next);
+	if(usedBlocks())
+		a.deallocate(outer[h], block_size);
+	if(spare != NULL)
+		a.deallocate(spare, block_size);
+	outer_allocator_type x(a);
+	x.deallocate(outer, outerSize);}
+
+// ------
+// at_seq
+// ------
+
+/**
+* O(1)
+* M(1)
+* @param n sequence number
+* @throw std::out_of_range
+* @return reference to the element pushed with sequence number n
+*/
+reference at_seq (sequence_type n){
+	if(n < base || n >= next)
+		throw std::out_of_range("deque sequence number out of range");
+	return *slot(n);}
+
+/**
+* O(1)
+* M(1)
+* @param n sequence number
+* @throw std::out_of_range
+* @return constant reference to the element pushed with sequence number n
+*/
+const_reference at_seq (sequence_type n)const {
+	return const_cast<SequencedDeque*>(this)->at_seq(n);}
+
+// -----------
+// operator []
+// -----------
+
+/**
+* O(1)
+* M(1)
+* @param index element index relative to the front
+* @return reference to value at the index'th position
+*/
+reference operator [] (size_type index){
+	return *slot(base + index);}
+
+/**
+* O(1)
+* M(1)
+* @param index element index relative to the front
+* @return constant reference to value at the index'th position
+*/
+const_reference operator [] (size_type index)const {
+	return *slot(base + index);}
+
+// ------------
+// contains_seq
+// ------------
+
+/**
+* O(1)
+* M(1)
+* @param n sequence number
+* @return true if the element pushed with sequence number n is still held
+*/
+bool contains_seq (sequence_type n)const {
+	return (n >= base) && (n < next);}
+
+/**
+* O(1)
+* M(1)
+* @return sequence number of the front element (next_seq() if empty)
+*/
+sequence_type front_seq ()const {
+	return base;}
+
+/**
+* O(1)
+* M(1)
+* @return sequence number the next push_back gets
+*/
+sequence_type next_seq ()const {
+	return next;}
+
+// -----------
+// front, back
+// -----------
+
+reference front (){
+	return *slot(base);}
+
+const_reference front ()const {
+	return *slot(base);}
+
+reference back (){
+	return *slot(next - 1);}
+
+const_reference back ()const {
+	return *slot(next - 1);}
+
+// ---------
+// push_back
+// ---------
+
+/**
+* ~O(1), unless the outer array must grow
+* M(1)
+* @param v value to append
+* @return sequence number of the new element
+*/
+sequence_type push_back (const_reference v){
+	if(next % block_size == 0){
+		size_type u = usedBlocks();
+		if(u == outerSize) grow();
+		outer[(h + u) & (outerSize - 1)] = takeBlock();}
+	a.construct(slot(next), v);
+	assert(valid());
+	return next++;}
+
+// ---------
+// pop_front
+// ---------
+
+/**
+* O(1)
+* M(1)
+*/
+void pop_front (){
+	assert(!empty());
+	advance(base + 1);
+	assert(valid());}
+
+// --------------
+// trim_until_seq
+// --------------
+
+/**
+* drops every element with a sequence number below n
+* O(1) plus O(blocks released), plus O(elements dropped) unless T is trivially destructible
+* M(1)
+* @param n first sequence number to keep; clamped to [front_seq(), next_seq()]
+*/
+void trim_until_seq (sequence_type n){
+	if(n <= base)
+		return;
+	advance((n < next) ? n : next);
+	assert(valid());}
+
+// -----
+// clear
+// -----
+
+void clear (){
+	trim_until_seq(next);}
+
+// -----
+// empty
+// -----
+
+bool empty ()const {
+	return base == next;}
+
+// ----
+// size
+// ----
+
+size_type size ()const {
+	return (size_type)(next - base);}};
+
+} // deque
+} // prog
+} // dt
+
+#endif // SequencedDeque_h
@@ -0,0 +1,105 @@
+// -------------------------------
+// prog/deque/SequencedDequeTest.h
+// Tj Wrenn
+// -------------------------------
+
+#ifndef SequencedDequeTest_h
+#define SequencedDequeTest_h
+
+// --------
+// includes
+// --------
+
+#include <cassert>   // assert
+#include <stdexcept> // out_of_range
+#include <string>    // string
+
+// ----------
+// namespaces
+// ----------
+
+namespace dt {
+namespace prog  {
+namespace deque  {
+
+// --------------------
+// sequenced_deque_test
+// --------------------
+
+/**
+ * function sequenced_deque_test is a tester of class SequencedDeque
+ */
+template <typename SequencedDeque>
+void sequenced_deque_test () {
+	{
+	// sequence numbers survive pop_front
+	SequencedDeque a;
+	assert(a.empty());
+	for(int i = 0; i < 500; ++i)
+		assert(a.push_back(i * 10) == (unsigned)i);
+	assert(a.front_seq() == 0);
+	assert(a.next_seq() == 500);
+
+	a.pop_front();
+	a.pop_front();
+	assert(a.front_seq() == 2);
+	assert(a.front() == 20);
+	assert(a.at_seq(2) == 20);
+	assert(a.at_seq(499) == 4990);
+	assert(a[0] == 20);
+	assert(!a.contains_seq(1));
+
+	try {
+		a.at_seq(1);
+		assert(false);
+	} catch (const std::out_of_range& e) {
+		assert(std::string(e.what()) == "deque sequence number out of range");
+	}
+	try {
+		a.at_seq(500);
+		assert(false);
+	} catch (const std::out_of_range& e) {
+		assert(std::string(e.what()) == "deque sequence number out of range");
+	}
+	}
+
+	{
+	// trimming across and within blocks
+	SequencedDeque a(1000);
+	for(int i = 0; i < 300; ++i)
+		a.push_back(i);
+	a.trim_until_seq(1130);
+	assert(a.front_seq() == 1130);
+	assert(a.size() == 170);
+	assert(a.at_seq(1131) == 131);
+	assert(a.back() == 299);
+
+	a.trim_until_seq(10); // already gone
+	assert(a.front_seq() == 1130);
+
+	a.trim_until_seq(5000); // clamped to next_seq()
+	assert(a.empty());
+	assert(a.front_seq() == 1300);
+	assert(a.push_back(7) == 1300);
+	assert(a.at_seq(1300) == 7);
+	}
+
+	{
+	// steady FIFO wrapping around the outer array
+	SequencedDeque a(60);
+	for(int i = 0; i < 100000; ++i){
+		a.push_back(i);
+		if(a.size() > 150)
+			a.trim_until_seq(a.front_seq() + 50);
+		assert(a.at_seq(60 + i) == i);}
+	assert(a.at_seq(a.front_seq()) == a.front());
+	a.clear();
+	assert(a.size() == 0);
+	}
+} // sequenced_deque_test
+
+} // deque
+} // prog
+} // dt
+
+#endif // SequencedDequeTest_h
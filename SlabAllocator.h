@@ -0,0 +1,260 @@
+// --------------------------
+// prog/deque/SlabAllocator.h
+// Tj Wrenn
+// --------------------------
+
+#ifndef SlabAllocator_h
+#define SlabAllocator_h
+
+// --------
+// includes
+// --------
+
+#include <algorithm> // find
+#include <cstddef> // size_t, max_align_t
+#include <new> // operator new, operator delete
+#include <vector> // vector
+
+#include "BlockCache.h"
+
+// ----------
+// namespaces
+// ----------
+
+namespace dt{
+namespace prog{
+namespace deque{
+
+// ---------
+// SlabCache
+// ---------
+
+/**
+* Carves equally sized blocks out of slabs, each slab one operator new call
+* holding twice the blocks of the one before, up to a limit, so a Deque
+* growing to n blocks makes O(log n) calls to the heap rather than n, and
+* blocks allocated one after another sit next to each other in memory.
+*
+* Every block is preceded by a pointer back to its slab, and every slab
+* counts the blocks it has handed out.  A freed block goes on its slab's free
+* list, to be handed out again before the slab's untouched blocks, and a
+* slab whose count drops to zero goes back to the heap, unless it is the
+* newest.  take() looks for room from the newest slab back, so it is
+* O(number of slabs) at worst.
+*/
+class SlabCache{
+public:
+// --------
+// typedefs
+// --------
+
+typedef std::size_t size_type;
+
+/**
+* blocks of a slab can only go back to it
+*/
+static const bool heap_blocks = false;
+
+private:
+// ----
+// Slab
+// ----
+
+struct Slab{
+	/**
+	* next untouched block, and the end of the slab
+	*/
+	char* next;
+	char* end;
+
+	/**
+	* freed blocks, each holding a pointer to the next
+	*/
+	void* free;
+
+	/**
+	* number of blocks handed out and not yet freed
+	*/
+	size_type live;};
+
+/**
+* room for the back pointer ahead of each block, keeping blocks aligned
+*/
+static const size_type header = alignof(std::max_align_t);
+
+/**
+* room for the Slab itself, ahead of its first block
+*/
+static const size_type top = (sizeof(Slab) + header - 1) / header * header;
+
+// ----
+// data
+// ----
+
+/**
+* size in bytes of the blocks carved, or 0 before the first one, and the
+* distance between the starts of two neighbouring blocks
+*/
+size_type bytes;
+size_type stride;
+
+/**
+* number of blocks in the next slab, and the most a slab holds
+*/
+size_type grow;
+size_type limit;
+
+std::vector<Slab*> slabs;
+
+size_type allocations;
+
+// -------
+// copying
+// -------
+
+SlabCache (const SlabCache&);
+SlabCache& operator = (const SlabCache&);
+
+/**
+* O(1)
+* M(n * stride)
+* @param n number of blocks
+* @return a new slab of n blocks
+*/
+Slab* make (size_type n){
+	char* p = static_cast<char*>(::operator new(top + n * stride));
+	Slab* s = reinterpret_cast<Slab*>(p);
+	s->next = p + top;
+	s->end = s->next + n * stride;
+	s->free = NULL;
+	s->live = 0;
+	++allocations;
+	return s;}
+
+public:
+// ---------
+// SlabCache
+// ---------
+
+/**
+* O(1)
+* M(1)
+* @param first number of blocks in the first slab
+* @param limit most blocks in one slab
+*/
+explicit SlabCache (size_type first = 4, size_type limit = 4096)
+	: bytes(0), stride(0), grow(first ? first : 1), limit(limit), allocations(0) {}
+
+/**
+* O(n), where n is the number of slabs
+* M(1)
+*/
+~SlabCache (){
+	for(size_type i = 0; i < slabs.size(); ++i)
+		::operator delete(slabs[i]);}
+
+// ----
+// take
+// ----
+
+/**
+* O(1) while the newest slab has room, O(number of slabs) at worst
+* M(n)
+* @param n size in bytes
+* @return a block of n bytes from a slab, or from operator new for another size
+*/
+void* take (size_type n){
+	if(!bytes){
+		bytes = n;
+		stride = header + (n + header - 1) / header * header;}
+	if(n != bytes)
+		return ::operator new(n);
+	Slab* s = NULL;
+	for(size_type i = slabs.size(); i-- > 0; )
+		if(slabs[i]->free || slabs[i]->next != slabs[i]->end){
+			s = slabs[i];
+			break;}
+	if(s == NULL){
+		s = make(grow);
+		slabs.push_back(s);
+		if(grow < limit)
+			grow = (grow * 2 < limit) ? grow * 2 : limit;}
+	char* p;
+	if(s->free){
+		p = static_cast<char*>(s->free);
+		s->free = *reinterpret_cast<void**>(p);}
+	else{
+		p = s->next + header;
+		s->next += stride;
+		reinterpret_cast<Slab**>(p)[-1] = s;}
+	++s->live;
+	return p;}
+
+// ----
+// give
+// ----
+
+/**
+* O(1), O(number of slabs) when a slab is released
+* M(1)
+* @param p a block from take()
+* @param n its size in bytes
+*/
+void give (void* p, size_type n){
+	if(n != bytes){
+		::operator delete(p);
+		return;}
+	Slab* s = reinterpret_cast<Slab**>(p)[-1];
+	*reinterpret_cast<void**>(p) = s->free;
+	s->free = p;
+	if(--s->live == 0 && s != slabs.back()){
+		slabs.erase(std::find(slabs.begin(), slabs.end(), s));
+		::operator delete(s);}}
+
+// -----
+// slabs
+// -----
+
+/**
+* O(1)
+* M(1)
+* @return number of slabs held
+*/
+size_type size ()const {
+	return slabs.size();}
+
+/**
+* O(1)
+* M(1)
+* @return number of slabs allocated since construction
+*/
+size_type slab_allocations ()const {
+	return allocations;}
+
+/**
+* O(1)
+* M(1)
+* @return distance in bytes between neighbouring blocks of a slab
+*/
+size_type block_stride ()const {
+	return stride;}};
+
+// -------------
+// SlabAllocator
+// -------------
+
+/**
+* an allocator drawing Deque blocks from a SlabCache (see CachedAllocator), e.g.
+*
+*     SlabCache slabs;
+*     SlabAllocator<int> s(&slabs);
+*     Deque<int, SlabAllocator<int> > x(s);
+*/
+template <typename T>
+using SlabAllocator = CachedAllocator<T, SlabCache>;
+
+} // deque
+} // prog
+} // dt
+
+#endif // SlabAllocator_h
@@ -0,0 +1,91 @@
+// ------------------------------
+// prog/deque/SlabAllocatorTest.h
+// Tj Wrenn
+// ------------------------------
+
+#ifndef SlabAllocatorTest_h
+#define SlabAllocatorTest_h
+
+// --------
+// includes
+// --------
+
+#include <cassert> // assert
+#include <utility> // move
+
+#include "SlabAllocator.h"
+
+// ----------
+// namespaces
+// ----------
+
+namespace dt {
+namespace prog  {
+namespace deque  {
+
+// -------------------
+// slab_allocator_test
+// -------------------
+
+/**
+ * function slab_allocator_test is a tester of SlabCache and SlabAllocator,
+ * instantiated with a Deque of an integral type over a SlabAllocator
+ */
+template <typename Deque>
+void slab_allocator_test () {
+	typedef typename Deque::value_type     value_type;
+	typedef typename Deque::size_type      size_type;
+	typedef typename Deque::allocator_type allocator_type;
+
+	{
+	SlabCache slabs(4, 1 << 20);
+	allocator_type h(&slabs);
+	{
+	Deque x(h);
+	for(int i = 0; i < 100000; ++i)
+		x.push_back(value_type(i));
+	for(int i = 0; i < 100000; ++i)
+		assert(x[i] == value_type(i));
+	size_type blocks = 0;
+	for(size_type i = 0; i < x.size(); i += x.segment_length(i))
+		++blocks;
+	assert(blocks > 500);
+	assert(slabs.slab_allocations() <= 10);
+	size_type n = x.segment_length(0);
+	const char* p = reinterpret_cast<const char*>(&x[n]);
+	const char* q = reinterpret_cast<const char*>(&x[n + x.segment_length(n)]);
+	assert((size_type)(q - p) == slabs.block_stride());
+	}
+	assert(slabs.size() == 1);
+	size_type made = slabs.slab_allocations();
+	{
+	Deque y(h);
+	for(int i = 0; i < 1000; ++i)
+		y.push_front(value_type(i));
+	Deque z(h);
+	z.push_back(value_type(-1));
+	z.append(std::move(y));
+	assert(z.size() == 1001);
+	assert(z.front() == value_type(-1) && z.back() == value_type(0));
+	}
+	assert(slabs.slab_allocations() == made);
+	}
+
+	{
+	SlabCache slabs(1, 2);
+	allocator_type h(&slabs);
+	{
+	Deque x(h);
+	for(int i = 0; i < 5000; ++i)
+		x.push_back(value_type(i));
+	assert(slabs.size() > 10);
+	}
+	assert(slabs.size() == 1);
+	}
+} // slab_allocator_test
+
+} // deque
+} // prog
+} // dt
+
+#endif // SlabAllocatorTest_h
@@ -0,0 +1,313 @@
+// ---------------------------------
+// prog/deque/SlidingWindowExtrema.h
+// Tj Wrenn
+// ---------------------------------
+
+#ifndef SlidingWindowExtrema_h
+#define SlidingWindowExtrema_h
+
+// --------
+// includes
+// --------
+
+#include <cassert> // assert
+#include <functional> // less
+#include <memory> // allocator
+
+#include "Deque.h"
+
+// ----------
+// namespaces
+// ----------
+
+namespace dt{
+namespace prog{
+namespace deque{
+
+// --------------------
+// SlidingWindowExtrema
+// --------------------
+
+/**
+* The minimum and maximum, under Compare, of a window sliding over a stream.
+*
+* Two monotonic Deques hold (sequence number, value) entries: the front of
+* one is the window's minimum and the front of the other its maximum.  A
+* push pops from the back every entry it outranks, so each value is pushed
+* and popped at most once per Deque and push, evict, min and max are
+* amortized O(1).  A Deque used as a FIFO reuses the blocks its front leaves
+* behind, so once both have grown to the window's worst case no push
+* allocates.
+*
+* The window is either the last window() pushes, evicted by push itself, or,
+* with a window of 0, whatever evict() and evict_until_seq() leave.
+*/
+template < typename T, typename C = std::less<T>, typename A = std::allocator<T> >
+class SlidingWindowExtrema{
+public:
+// --------
+// typedefs
+// --------
+
+typedef A allocator_type;
+typedef typename allocator_type::value_type value_type;
+
+typedef typename allocator_type::size_type size_type;
+
+typedef typename allocator_type::const_reference const_reference;
+
+typedef C value_compare;
+typedef unsigned long long sequence_type;
+
+private:
+// -----
+// Entry
+// -----
+
+struct Entry{
+	sequence_type seq;
+	value_type value;
+
+	Entry ()
+		: seq(0), value() {}
+
+	Entry (sequence_type seq, const_reference value)
+		: seq(seq), value(value) {}};
+
+typedef Deque<Entry, typename A::template rebind<Entry>::other> entry_deque;
+
+// ----
+// data
+// ----
+
+/**
+* values increasing under comp from the front, and decreasing
+*/
+entry_deque lows;
+entry_deque highs;
+
+value_compare comp;
+
+/**
+* number of elements in the window, or 0 to evict by hand
+*/
+size_type w;
+
+/**
+* sequence number of the oldest element in the window, and of the next push
+*/
+sequence_type first;
+sequence_type next;
+
+// -----
+// valid
+// -----
+
+/**
+* O(1)
+* M(1)
+* @return true if aggregator is in valid state
+*/
+bool valid ()const {
+	return (first <= next) && (lows.empty() == (first == next)) && (highs.empty() == (first == next)) && (!w || next - first <= w);}
+
+/**
+* drops the entries older than first
+* amortized O(1)
+* M(1)
+*/
+void trim (){
+	while(!lows.empty() && lows.front().seq < first)
+		lows.pop_front();
+	while(!highs.empty() && highs.front().seq < first)
+		highs.pop_front();}
+
+/**
+* adds v as sequence number next, evicting the oldest element if the window is full
+* amortized O(1)
+* M(1)
+* @param v value to add
+*/
+void add (const_reference v){
+	value_type x = v; // v may be an entry the pops below destroy, as min() is
+	while(!lows.empty() && !comp(lows.back().value, x))
+		lows.pop_back();
+	lows.push_back(Entry(next, x));
+	while(!highs.empty() && !comp(x, highs.back().value))
+		highs.pop_back();
+	highs.push_back(Entry(next, x));
+	++next;
+	if(w && next - first > w){
+		++first;
+		trim();}}
+
+public:
+// --------------------
+// SlidingWindowExtrema
+// --------------------
+
+/**
+* O(1)
+* M(block_size)
+* @param window number of elements in the window, or 0 to evict by hand
+* @param comp ordering of the values
+* @param first sequence number the first push gets
+*/
+explicit SlidingWindowExtrema (size_type window = 0, const value_compare& comp = value_compare(), sequence_type first = 0)
+	: comp(comp), w(window), first(first), next(first) {
+		assert(valid());}
+
+// ----
+// push
+// ----
+
+/**
+* amortized O(1)
+* M(1)
+* @param v value to add to the window
+* @return sequence number of v
+*/
+sequence_type push (const_reference v){
+	add(v);
+	assert(valid());
+	return next - 1;}
+
+// ------
+// push_n
+// ------
+
+/**
+* pushes n values from an array, such as one segment of a Deque
+* amortized O(n)
+* M(1)
+* @param p values to push
+* @param n number of values
+*/
+void push_n (const value_type* p, size_type n){
+	for(size_type i = 0; i < n; ++i)
+		add(p[i]);
+	assert(valid());}
+
+/**
+* pushes n values from an array, recording the window's extremes after each one
+* amortized O(n)
+* M(1)
+* @param p values to push
+* @param n number of values
+* @param mins where to write the minimum after each push, or NULL
+* @param maxs where to write the maximum after each push, or NULL
+*/
+void push_n (const value_type* p, size_type n, value_type* mins, value_type* maxs){
+	for(size_type i = 0; i < n; ++i){
+		add(p[i]);
+		if(mins != NULL) mins[i] = lows.front().value;
+		if(maxs != NULL) maxs[i] = highs.front().value;}
+	assert(valid());}
+
+// -----
+// evict
+// -----
+
+/**
+* drops the oldest element of the window
+* amortized O(1)
+* M(1)
+*/
+void evict (){
+	assert(!empty());
+	++first;
+	trim();
+	assert(valid());}
+
+/**
+* drops every element with a sequence number below n
+* amortized O(1) per element dropped
+* M(1)
+* @param n first sequence number to keep; clamped to [front_seq(), next_seq()]
+*/
+void evict_until_seq (sequence_type n){
+	if(n <= first)
+		return;
+	first = (n < next) ? n : next;
+	trim();
+	assert(valid());}
+
+// --------
+// min, max
+// --------
+
+/**
+* O(1)
+* M(1)
+* @return the least value in the window, the newest of them if several are equivalent
+*/
+const_reference min ()const {
+	assert(!empty());
+	return lows.front().value;}
+
+/**
+* O(1)
+* M(1)
+* @return the greatest value in the window, the newest of them if several are equivalent
+*/
+const_reference max ()const {
+	assert(!empty());
+	return highs.front().value;}
+
+/**
+* O(1)
+* M(1)
+* @return sequence numbers of the values min() and max() return
+*/
+sequence_type min_seq ()const {
+	return lows.front().seq;}
+
+sequence_type max_seq ()const {
+	return highs.front().seq;}
+
+// -------------------
+// front_seq, next_seq
+// -------------------
+
+sequence_type front_seq ()const {
+	return first;}
+
+sequence_type next_seq ()const {
+	return next;}
+
+// ------
+// window
+// ------
+
+size_type window ()const {
+	return w;}
+
+// -----
+// clear
+// -----
+
+/**
+* empties the window, keeping the sequence numbers going
+*/
+void clear (){
+	evict_until_seq(next);}
+
+// -----
+// empty
+// -----
+
+bool empty ()const {
+	return first == next;}
+
+// ----
+// size
+// ----
+
+size_type size ()const {
+	return (size_type)(next - first);}};
+
+} // deque
+} // prog
+} // dt
+
+#endif // SlidingWindowExtrema_h
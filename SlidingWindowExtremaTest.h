@@ -0,0 +1,125 @@
+// -------------------------------------
+// prog/deque/SlidingWindowExtremaTest.h
+// Tj Wrenn
+// -------------------------------------
+
+#ifndef SlidingWindowExtremaTest_h
+#define SlidingWindowExtremaTest_h
+
+// --------
+// includes
+// --------
+
+#include <algorithm> // max_element, min_element
+#include <cassert>   // assert
+#include <cstdlib>   // rand, srand
+#include <string>    // string
+#include <vector>    // vector
+
+// ----------
+// namespaces
+// ----------
+
+namespace dt {
+namespace prog  {
+namespace deque  {
+
+// ---------------------------
+// sliding_window_extrema_test
+// ---------------------------
+
+/**
+ * function sliding_window_extrema_test is a tester of class
+ * SlidingWindowExtrema, instantiated with an integral element type
+ */
+template <typename SlidingWindowExtrema>
+void sliding_window_extrema_test () {
+	typedef typename SlidingWindowExtrema::value_type    value_type;
+	typedef typename SlidingWindowExtrema::size_type     size_type;
+	typedef typename SlidingWindowExtrema::sequence_type sequence_type;
+
+	{
+	// a fixed window agrees with a scan of the last w values
+	std::srand(29);
+	const size_type w = 37;
+	SlidingWindowExtrema a(w);
+	std::vector<value_type> v;
+	for(int i = 0; i < 5000; ++i){
+		value_type x = (value_type)(std::rand() % 50);
+		assert(a.push(x) == (sequence_type)i);
+		v.push_back(x);
+		size_type lo = (v.size() > w) ? v.size() - w : 0;
+		assert(a.size() == v.size() - lo);
+		assert(a.min() == *std::min_element(v.begin() + lo, v.end()));
+		assert(a.max() == *std::max_element(v.begin() + lo, v.end()));
+		assert(v[a.min_seq()] == a.min() && v[a.max_seq()] == a.max());}
+	}
+
+	{
+	// push_n writes the extremes after every push
+	const size_type w = 5;
+	SlidingWindowExtrema a(w);
+	std::vector<value_type> v;
+	for(int i = 0; i < 1000; ++i)
+		v.push_back((value_type)((i * 7919) % 101));
+	std::vector<value_type> mins(v.size());
+	std::vector<value_type> maxs(v.size());
+	a.push_n(&v[0], 600, &mins[0], &maxs[0]);
+	a.push_n(&v[600], 400, &mins[600], NULL);
+	for(size_type i = 0; i < v.size(); ++i){
+		size_type lo = (i + 1 > w) ? i + 1 - w : 0;
+		assert(mins[i] == *std::min_element(v.begin() + lo, v.begin() + i + 1));
+		if(i < 600)
+			assert(maxs[i] == *std::max_element(v.begin() + lo, v.begin() + i + 1));}
+	}
+
+	{
+	// evicting by hand
+	std::srand(31);
+	SlidingWindowExtrema a;
+	std::vector<value_type> v;
+	size_type first = 0;
+	for(int i = 0; i < 5000; ++i){
+		if(first < v.size() && std::rand() % 3 == 0){
+			if(std::rand() % 2){
+				a.evict();
+				++first;}
+			else{
+				first += std::rand() % (v.size() - first + 1);
+				a.evict_until_seq(first);}}
+		else{
+			value_type x = (value_type)(std::rand() % 1000);
+			a.push(x);
+			v.push_back(x);}
+		assert(a.size() == v.size() - first);
+		assert(a.front_seq() == first);
+		if(!a.empty()){
+			assert(a.min() == *std::min_element(v.begin() + first, v.end()));
+			assert(a.max() == *std::max_element(v.begin() + first, v.end()));}}
+	a.clear();
+	assert(a.empty() && a.next_seq() == v.size());
+	}
+
+	{
+	// pushing the current minimum or maximum, whose entries the push pops
+	::dt::prog::deque::SlidingWindowExtrema<std::string> a(3);
+	a.push(std::string(40, 'm'));
+	a.push(std::string(40, 'z'));
+	a.push(std::string(40, 'a'));
+	a.push(a.max());
+	assert(a.max() == std::string(40, 'z') && a.min() == std::string(40, 'a'));
+	a.push(a.min());
+	a.push(a.min());
+	assert(a.min() == std::string(40, 'a') && a.max() == std::string(40, 'z'));
+	a.push(a.max());
+	a.push(a.max());
+	a.push(a.max());
+	assert(a.min() == std::string(40, 'z') && a.max() == std::string(40, 'z'));
+	}
+} // sliding_window_extrema_test
+
+} // deque
+} // prog
+} // dt
+
+#endif // SlidingWindowExtremaTest_h
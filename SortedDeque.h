@@ -0,0 +1,379 @@
+// -------------------------
+// prog/deque/SortedDeque.h
+// Tj Wrenn
+// -------------------------
+
+#ifndef SortedDeque_h
+#define SortedDeque_h
+
+// --------
+// includes
+// --------
+
+#include <algorithm> // lower_bound, move_backward, upper_bound
+#include <cassert> // assert
+#include <functional> // less
+#include <memory> // allocator
+#include <stdexcept> // invalid_argument, out_of_range
+#include <utility> // pair
+#include <vector> // vector
+
+#include "Deque.h"
+
+// ----------
+// namespaces
+// ----------
+
+namespace dt{
+namespace prog{
+namespace deque{
+
+// -----------
+// SortedDeque
+// -----------
+
+/**
+* A Deque kept sorted by Compare, with a fence index: a compact array holding
+* the first element of every block.  lower_bound() and upper_bound() binary
+* search the fences, which are contiguous and few, and then only the one
+* block the answer lies in, instead of probing a different block on every
+* step the way std::lower_bound through Deque::iterator does.
+*
+* push_back() of an element no smaller than back() adds a fence when it
+* starts a new block; pop_front() and pop_back() drop the fence of a block
+* they empty.  The fence of the front block may be left holding an element
+* already popped, which is no greater than front() and so still bounds the
+* block from below.
+*/
+template < typename T, typename C = std::less<T>, typename A = std::allocator<T> >
+class SortedDeque{
+public:
+// --------
+// typedefs
+// --------
+
+typedef Deque<T, A> deque_type;
+typedef C value_compare;
+
+typedef typename deque_type::allocator_type allocator_type;
+typedef typename deque_type::value_type value_type;
+
+typedef typename deque_type::size_type size_type;
+typedef typename deque_type::difference_type difference_type;
+
+typedef typename deque_type::const_reference const_reference;
+
+typedef typename deque_type::const_iterator const_iterator;
+
+private:
+// ----
+// data
+// ----
+
+deque_type d;
+value_compare comp;
+
+/**
+* fences[head + k] is the first element pushed into the k'th block of d
+*/
+std::vector<value_type> fences;
+size_type head;
+
+// -----
+// valid
+// -----
+
+/**
+* O(1)
+* M(1)
+* @return true if the fence index is in valid state
+*/
+bool valid ()const {
+	if(head > fences.size() || (blocks() == 0) != d.empty())
+		return false;
+	return d.empty() || index(blocks() - 1) + d.segment_length(index(blocks() - 1)) == d.size();}
+
+/**
+* O(1)
+* M(1)
+* @return number of fences, one per block holding elements
+*/
+size_type blocks ()const {
+	return fences.size() - head;}
+
+/**
+* O(1)
+* M(1)
+* @param k block number, counting the front block as 0
+* @return index of the first element of the k'th block
+*/
+size_type index (size_type k)const {
+	if(k == 0)
+		return 0;
+	size_type first = d.segment_length(0);
+	return (k == 1) ? first : first + (k - 1) * d.segment_length(first);}
+
+/**
+* drops the fence of the front block
+* amortized O(1)
+* M(1)
+*/
+void dropFront (){
+	++head;
+	if(head * 2 > fences.size()){
+		fences.erase(fences.begin(), fences.begin() + head);
+		head = 0;}}
+
+/**
+* O(log(n / block_size) + log(block_size))
+* M(1)
+* @param v value to search for
+* @param upper true for upper_bound, false for lower_bound
+* @return index of the first element not less than v, or greater than v if upper
+*/
+size_type search (const value_type& v, bool upper)const {
+	typename std::vector<value_type>::const_iterator b = fences.begin() + head;
+	size_type k = (upper ? std::upper_bound(b, fences.end(), v, comp) : std::lower_bound(b, fences.end(), v, comp)) - b;
+	if(k == 0)
+		return 0;
+	size_type i = index(k - 1);
+	const value_type* p = &d[i];
+	const value_type* e = p + d.segment_length(i);
+	return i + ((upper ? std::upper_bound(p, e, v, comp) : std::lower_bound(p, e, v, comp)) - p);}
+
+public:
+// -----------
+// SortedDeque
+// -----------
+
+/**
+* O(1)
+* M(1)
+* @param comp ordering of the elements
+* @param a allocator
+*/
+explicit SortedDeque (const value_compare& comp = value_compare(), const allocator_type& a = allocator_type())
+	: d(a), comp(comp), head(0) {
+		assert(valid());}
+
+// -----------
+// operator []
+// -----------
+
+/**
+* O(1)
+* M(1)
+* @param index element index
+* @return constant reference to value at the index'th position
+*/
+const_reference operator [] (size_type index)const {
+	return d[index];}
+
+// --
+// at
+// --
+
+/**
+* O(1)
+* M(1)
+* @param index element index
+* @throw std::out_of_range
+* @return constant reference to value at the index'th position
+*/
+const_reference at (size_type index)const {
+	return d.at(index);}
+
+// -----------
+// front, back
+// -----------
+
+const_reference front ()const {
+	return d.front();}
+
+const_reference back ()const {
+	return d.back();}
+
+// ----------
+// begin, end
+// ----------
+
+const_iterator begin ()const {
+	return d.begin();}
+
+const_iterator end ()const {
+	return d.end();}
+
+// -----
+// deque
+// -----
+
+/**
+* O(1)
+* M(1)
+* @return the underlying deque, for reading
+*/
+const deque_type& deque ()const {
+	return d;}
+
+// ---------
+// push_back
+// ---------
+
+/**
+* appends v, which must not be less than back()
+* ~O(1)
+* M(1)
+* @param v value to append
+* @throw std::invalid_argument if v is less than back()
+*/
+void push_back (const_reference v){
+	if(!d.empty() && comp(v, d.back()))
+		throw std::invalid_argument("sorted deque push_back out of order");
+	d.push_back(v);
+	if(d.size() == 1 || d.segment_length(d.size() - 2) == 1)
+		fences.push_back(v);
+	assert(valid());}
+
+// ------
+// insert
+// ------
+
+/**
+* inserts v after every element not greater than it
+* O(1) if v is not less than back(), else O(n - i)
+* M(1)
+* @param v value to insert
+* @return index of the new element
+*/
+size_type insert (const_reference v){
+	if(d.empty() || !comp(v, d.back())){
+		push_back(v);
+		return d.size() - 1;}
+	size_type i = search(v, true);
+	d.push_back(d.back());
+	if(d.segment_length(d.size() - 2) == 1)
+		fences.push_back(d.back());
+	typename deque_type::iterator b = d.begin();
+	std::move_backward(b + i, b + (d.size() - 2), b + (d.size() - 1));
+	d[i] = v;
+	for(size_type k = blocks(); k > 0 && index(k - 1) >= i; --k)
+		fences[head + k - 1] = d[index(k - 1)];
+	assert(valid());
+	return i;}
+
+// ---------
+// pop_front
+// ---------
+
+/**
+* O(1)
+* M(1)
+*/
+void pop_front (){
+	assert(!empty());
+	bool ends = d.segment_length(0) == 1;
+	d.pop_front();
+	if(d.empty())
+		clear();
+	else if(ends)
+		dropFront();
+	assert(valid());}
+
+// --------
+// pop_back
+// --------
+
+/**
+* O(1)
+* M(1)
+*/
+void pop_back (){
+	assert(!empty());
+	bool starts = d.size() == 1 || d.segment_length(d.size() - 2) == 1;
+	d.pop_back();
+	if(d.empty())
+		clear();
+	else if(starts)
+		fences.pop_back();
+	assert(valid());}
+
+// -----
+// clear
+// -----
+
+void clear (){
+	d.clear();
+	fences.clear();
+	head = 0;}
+
+// -----------
+// lower_bound
+// -----------
+
+/**
+* O(log(n / block_size) + log(block_size)), touching the fences and one block
+* M(1)
+* @param v value to search for
+* @return iterator to the first element not less than v, or end()
+*/
+const_iterator lower_bound (const value_type& v)const {
+	return d.begin() + search(v, false);}
+
+// -----------
+// upper_bound
+// -----------
+
+/**
+* O(log(n / block_size) + log(block_size)), touching the fences and one block
+* M(1)
+* @param v value to search for
+* @return iterator to the first element greater than v, or end()
+*/
+const_iterator upper_bound (const value_type& v)const {
+	return d.begin() + search(v, true);}
+
+// -----------
+// equal_range
+// -----------
+
+/**
+* O(log(n / block_size) + log(block_size))
+* M(1)
+* @param v value to search for
+* @return the range of elements equivalent to v
+*/
+std::pair<const_iterator, const_iterator> equal_range (const value_type& v)const {
+	return std::make_pair(lower_bound(v), upper_bound(v));}
+
+// -----
+// count
+// -----
+
+/**
+* O(log(n / block_size) + log(block_size))
+* M(1)
+* @param v value to search for
+* @return number of elements equivalent to v
+*/
+size_type count (const value_type& v)const {
+	return search(v, true) - search(v, false);}
+
+// -----
+// empty
+// -----
+
+bool empty ()const {
+	return d.empty();}
+
+// ----
+// size
+// ----
+
+size_type size ()const {
+	return d.size();}};
+
+} // deque
+} // prog
+} // dt
+
+#endif // SortedDeque_h
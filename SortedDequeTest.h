@@ -0,0 +1,111 @@
+// ----------------------------
+// prog/deque/SortedDequeTest.h
+// Tj Wrenn
+// ----------------------------
+
+#ifndef SortedDequeTest_h
+#define SortedDequeTest_h
+
+// --------
+// includes
+// --------
+
+#include <algorithm> // lower_bound, upper_bound
+#include <cassert>   // assert
+#include <cstdlib>   // rand, srand
+#include <stdexcept> // invalid_argument
+#include <vector>    // vector
+
+// ----------
+// namespaces
+// ----------
+
+namespace dt {
+namespace prog  {
+namespace deque  {
+
+// -----------------
+// sorted_deque_test
+// -----------------
+
+/**
+ * function sorted_deque_test is a tester of class SortedDeque, instantiated
+ * with an integral element type
+ */
+template <typename SortedDeque>
+void sorted_deque_test () {
+	typedef typename SortedDeque::value_type value_type;
+	typedef typename SortedDeque::size_type  size_type;
+
+	{
+	// empty
+	SortedDeque a;
+	assert(a.empty());
+	assert(a.lower_bound(5) == a.end());
+	assert(a.upper_bound(5) == a.end());
+	assert(a.count(5) == 0);
+	}
+
+	{
+	// push_back keeps order
+	SortedDeque a;
+	a.push_back(1);
+	a.push_back(1);
+	a.push_back(3);
+	bool thrown = false;
+	try {
+		a.push_back(2);}
+	catch(std::invalid_argument&) {
+		thrown = true;}
+	assert(thrown);
+	assert(a.size() == 3);
+	assert(a.lower_bound(1) == a.begin());
+	assert(a.upper_bound(1) - a.begin() == 2);
+	assert(a.count(1) == 2);
+	assert(a.lower_bound(4) == a.end());
+	}
+
+	{
+	// a sliding window of timestamps agrees with std::lower_bound and std::upper_bound
+	std::srand(5);
+	SortedDeque a;
+	std::vector<value_type> v;
+	size_type popped = 0;
+	value_type t = 0;
+	for(int r = 0; r < 20000; ++r){
+		int op = std::rand() % 10;
+		if(op < 6 || v.size() - popped < 3){
+			t += std::rand() % 3;
+			a.push_back(t);
+			v.push_back(t);}
+		else if(op < 8){
+			a.pop_front();
+			++popped;}
+		else if(op < 9){
+			a.pop_back();
+			v.pop_back();}
+		else{
+			value_type x = t - std::rand() % 50;
+			size_type i = a.insert(x);
+			typename std::vector<value_type>::iterator p = std::upper_bound(v.begin() + popped, v.end(), x);
+			assert(i == (size_type)(p - (v.begin() + popped)));
+			v.insert(p, x);}
+		assert(a.size() == v.size() - popped);
+		if(r % 7 == 0){
+			value_type x = t - std::rand() % 200;
+			assert(a.lower_bound(x) - a.begin() == std::lower_bound(v.begin() + popped, v.end(), x) - (v.begin() + popped));
+			assert(a.upper_bound(x) - a.begin() == std::upper_bound(v.begin() + popped, v.end(), x) - (v.begin() + popped));}}
+	for(size_type i = 0; i < a.size(); ++i)
+		assert(a[i] == v[popped + i]);
+	while(!a.empty())
+		a.pop_front();
+	a.push_back(7);
+	assert(a.lower_bound(7) == a.begin() && a.upper_bound(7) == a.end());
+	}
+} // sorted_deque_test
+
+} // deque
+} // prog
+} // dt
+
+#endif // SortedDequeTest_h
@@ -0,0 +1,496 @@
+// -------------------------
+// prog/deque/TieredVector.h
+// Tj Wrenn
+// -------------------------
+
+#ifndef TieredVector_h
+#define TieredVector_h
+
+// --------
+// includes
+// --------
+
+#include <cassert> // assert
+#include <memory> // allocator
+#include <stdexcept> // out_of_range
+#include <utility> // move, swap
+#include <vector> // vector
+
+// ----------
+// namespaces
+// ----------
+
+namespace dt{
+namespace prog{
+namespace deque{
+
+// ------------
+// TieredVector
+// ------------
+
+/**
+* A deque for workloads dominated by inserts and erases in the middle.
+*
+* Every block is a circular buffer of block_size() slots with its own head,
+* and every block but the first and the last is full.  An insert shifts
+* elements inside the one block it lands in, then hands one element from
+* each block to the next towards the nearer end, which for a full block is
+* a move and a head adjustment, not a shift.  Keeping block_size() near
+* sqrt(n), by rebuilding when n passes block_size()^2, makes insert and erase
+* O(sqrt(n)) moves; operator[] stays O(1), a shift, a mask and two loads.
+*/
+template < typename T, typename A = std::allocator<T> >
+class TieredVector{
+public:
+// --------
+// typedefs
+// --------
+
+typedef A allocator_type;
+typedef typename allocator_type::value_type value_type;
+
+typedef typename allocator_type::size_type size_type;
+typedef typename allocator_type::difference_type difference_type;
+
+typedef typename allocator_type::pointer pointer;
+typedef typename allocator_type::const_pointer const_pointer;
+
+typedef typename allocator_type::reference reference;
+typedef typename allocator_type::const_reference const_reference;
+
+private:
+// -------------
+// static consts
+// -------------
+
+/**
+* log2 of the smallest block size
+*/
+static const size_type min_shift = 5;
+
+// -----
+// Block
+// -----
+
+/**
+* a circular buffer; logical slot r is data[(head + r) & mask]
+*/
+struct Block{
+	pointer data;
+	size_type head;};
+
+typedef typename A::template rebind<Block>::other block_allocator_type;
+
+// ----
+// data
+// ----
+
+allocator_type a;
+std::vector<Block, block_allocator_type> blocks;
+
+/**
+* log2 of the block size
+*/
+size_type shift;
+
+/**
+* number of unused logical slots at the start of the first block, less than the block size
+*/
+size_type gap;
+
+size_type s;
+
+// -----
+// valid
+// -----
+
+/**
+* O(1)
+* M(1)
+* @return true if tiered vector is in valid state
+*/
+bool valid ()const {
+	return (shift >= min_shift) && (gap < bsize()) && (blocks.size() == ((gap + s) + bsize() - 1) / bsize()) && (s || !gap);}
+
+size_type bsize ()const {
+	return (size_type)1 << shift;}
+
+size_type mask ()const {
+	return bsize() - 1;}
+
+/**
+* O(1)
+* M(1)
+* @param b block number
+* @param r logical slot in block b
+* @return pointer to the slot
+*/
+pointer cell (size_type b, size_type r)const {
+	const Block& x = blocks[b];
+	return x.data + ((x.head + r) & mask());}
+
+/**
+* O(1)
+* M(1)
+* @param j logical position, counting the unused slots of the first block
+* @return pointer to the slot
+*/
+pointer slot (size_type j)const {
+	return cell(j >> shift, j & mask());}
+
+/**
+* O(1)
+* M(block_size)
+* @return an empty block
+*/
+Block createBlock (){
+	Block x;
+	x.data = a.allocate(bsize());
+	x.head = 0;
+	return x;}
+
+/**
+* moves an element between two slots, leaving from unconstructed
+* @param to an unconstructed slot
+* @param from a constructed slot
+*/
+void relocate (pointer to, pointer from){
+	a.construct(to, std::move(*from));
+	a.destroy(from);}
+
+/**
+* rebuilds with blocks of 2^newShift slots, starting at the first slot
+* O(n + n / block_size)
+* M(n)
+* @param newShift log2 of the new block size
+*/
+void rebuild (size_type newShift){
+	std::vector<Block, block_allocator_type> old(blocks.get_allocator());
+	old.swap(blocks);
+	size_type oldShift = shift;
+	size_type oldGap = gap;
+	shift = newShift;
+	gap = 0;
+	for(size_type i = 0; i < s; ++i){
+		size_type j = oldGap + i;
+		const Block& x = old[j >> oldShift];
+		pointer p = x.data + ((x.head + j) & (((size_type)1 << oldShift) - 1));
+		if((i & mask()) == 0)
+			blocks.push_back(createBlock());
+		relocate(blocks.back().data + (i & mask()), p);}
+	for(size_type i = 0; i < old.size(); ++i)
+		a.deallocate(old[i].data, (size_type)1 << oldShift);}
+
+/**
+* grows or shrinks the blocks once n leaves [block_size^2 / 8, block_size^2]
+* amortized O(1)
+* M(1)
+*/
+void balance (){
+	if(s > bsize() * bsize())
+		rebuild(shift + 1);
+	else if(shift > min_shift && s < bsize() * bsize() / 8)
+		rebuild(shift - 1);}
+
+/**
+* frees the last block once it holds nothing
+* O(1)
+* M(1)
+*/
+void trimBack (){
+	if(((gap + s) & mask()) == 0 || s == 0){
+		size_type n = s ? (gap + s) >> shift : 0;
+		while(blocks.size() > n){
+			a.deallocate(blocks.back().data, bsize());
+			blocks.pop_back();}
+		if(!s)
+			gap = 0;}}
+
+/**
+* frees the first block once it holds nothing
+* O(n / block_size)
+* M(1)
+*/
+void trimFront (){
+	if(gap == bsize()){
+		a.deallocate(blocks.front().data, bsize());
+		blocks.erase(blocks.begin());
+		gap = 0;}}
+
+// -------
+// copying
+// -------
+
+TieredVector (const TieredVector&);
+TieredVector& operator = (const TieredVector&);
+
+public:
+// ------------
+// TieredVector
+// ------------
+
+/**
+* O(1)
+* M(1)
+* @param a allocator
+*/
+explicit TieredVector (const allocator_type& a = allocator_type())
+	: a(a), blocks(block_allocator_type(a)), shift(min_shift), gap(0), s(0) {
+		assert(valid());}
+
+/**
+* O(n + n / block_size)
+* M(1)
+*/
+~TieredVector (){
+	clear();}
+
+// -----------
+// operator []
+// -----------
+
+/**
+* O(1)
+* M(1)
+* @param index element index
+* @return reference to value at the index'th position
+*/
+reference operator [] (size_type index){
+	return *slot(gap + index);}
+
+/**
+* O(1)
+* M(1)
+* @param index element index
+* @return constant reference to value at the index'th position
+*/
+const_reference operator [] (size_type index)const {
+	return *slot(gap + index);}
+
+// --
+// at
+// --
+
+/**
+* O(1)
+* M(1)
+* @param index element index
+* @throw std::out_of_range
+* @return reference to value at the index'th position
+*/
+reference at (size_type index){
+	if(index >= s)
+		throw std::out_of_range("deque [] access out of range");
+	return (*this)[index];}
+
+/**
+* O(1)
+* M(1)
+* @param index element index
+* @throw std::out_of_range
+* @return constant reference to value at the index'th position
+*/
+const_reference at (size_type index)const {
+	return const_cast<TieredVector*>(this)->at(index);}
+
+// -----------
+// front, back
+// -----------
+
+reference front (){
+	return (*this)[0];}
+
+const_reference front ()const {
+	return (*this)[0];}
+
+reference back (){
+	return (*this)[s - 1];}
+
+const_reference back ()const {
+	return (*this)[s - 1];}
+
+// ----------
+// block_size
+// ----------
+
+/**
+* O(1)
+* M(1)
+* @return number of slots in a block, about sqrt(size())
+*/
+size_type block_size ()const {
+	return bsize();}
+
+// ------
+// insert
+// ------
+
+/**
+* inserts v before the index'th element, moving the elements on the nearer side
+* O(block_size + n / block_size), which is O(sqrt(n))
+* M(1)
+* @param index position of the new element, at most size()
+* @param v value to insert
+*/
+void insert (size_type index, const_reference v){
+	assert(index <= s);
+	value_type x = v; // v may be an element of this tiered vector
+	if(index * 2 >= s){
+		size_type e = gap + s;
+		if((e >> shift) == blocks.size())
+			blocks.push_back(createBlock());
+		size_type j = gap + index;
+		size_type k = j >> shift;
+		size_type u = e & mask();
+		for(size_type b = e >> shift; b > k; --b){
+			if(b != (e >> shift) || u)
+				blocks[b].head = (blocks[b].head - 1) & mask();
+			relocate(cell(b, 0), cell(b - 1, mask()));
+			u = mask();}
+		size_type r = j & mask();
+		if(r == u)
+			a.construct(cell(k, r), std::move(x));
+		else{
+			a.construct(cell(k, u), std::move(*cell(k, u - 1)));
+			for(size_type q = u - 1; q > r; --q)
+				*cell(k, q) = std::move(*cell(k, q - 1));
+			*cell(k, r) = std::move(x);}}
+	else{
+		if(gap == 0){
+			blocks.insert(blocks.begin(), createBlock());
+			gap = bsize();}
+		size_type t = gap + index - 1;
+		size_type k = t >> shift;
+		size_type u = (gap - 1) & mask();
+		for(size_type b = 0; b < k; ++b){
+			blocks[b].head = (blocks[b].head + 1) & mask();
+			relocate(cell(b, mask()), cell(b + 1, 0));
+			u = 0;}
+		size_type r = t & mask();
+		if(r == u)
+			a.construct(cell(k, r), std::move(x));
+		else{
+			a.construct(cell(k, u), std::move(*cell(k, u + 1)));
+			for(size_type q = u + 1; q < r; ++q)
+				*cell(k, q) = std::move(*cell(k, q + 1));
+			*cell(k, r) = std::move(x);}
+		--gap;}
+	++s;
+	balance();
+	assert(valid());}
+
+// -----
+// erase
+// -----
+
+/**
+* erases the index'th element, moving the elements on the nearer side
+* O(block_size + n / block_size), which is O(sqrt(n))
+* M(1)
+* @param index position of the element, less than size()
+*/
+void erase (size_type index){
+	assert(index < s);
+	size_type j = gap + index;
+	size_type k = j >> shift;
+	size_type r = j & mask();
+	if(index * 2 >= s){
+		size_type last = (gap + s - 1) >> shift;
+		size_type top = (k < last) ? mask() : ((gap + s - 1) & mask());
+		for(size_type q = r; q < top; ++q)
+			*cell(k, q) = std::move(*cell(k, q + 1));
+		a.destroy(cell(k, top));
+		for(size_type b = k + 1; b <= last; ++b){
+			relocate(cell(b - 1, mask()), cell(b, 0));
+			blocks[b].head = (blocks[b].head + 1) & mask();}
+		--s;
+		trimBack();}
+	else{
+		size_type bottom = (k > 0) ? 0 : gap;
+		for(size_type q = r; q > bottom; --q)
+			*cell(k, q) = std::move(*cell(k, q - 1));
+		a.destroy(cell(k, bottom));
+		for(size_type b = k; b > 0; --b){
+			relocate(cell(b, 0), cell(b - 1, mask()));
+			blocks[b - 1].head = (blocks[b - 1].head - 1) & mask();}
+		++gap;
+		--s;
+		if(!s)
+			trimBack();
+		else
+			trimFront();}
+	balance();
+	assert(valid());}
+
+// ---------------------
+// push_back, push_front
+// ---------------------
+
+/**
+* ~O(1)
+* M(1)
+* @param v value to append
+*/
+void push_back (const_reference v){
+	insert(s, v);}
+
+/**
+* ~O(1), plus O(n / block_size) when a block is added at the front
+* M(1)
+* @param v value to prepend
+*/
+void push_front (const_reference v){
+	insert(0, v);}
+
+// -------------------
+// pop_back, pop_front
+// -------------------
+
+/**
+* ~O(1)
+* M(1)
+*/
+void pop_back (){
+	erase(s - 1);}
+
+/**
+* ~O(1), plus O(n / block_size) when the first block empties
+* M(1)
+*/
+void pop_front (){
+	erase(0);}
+
+// -----
+// clear
+// -----
+
+/**
+* O(n + n / block_size)
+* M(1)
+*/
+void clear (){
+	for(size_type i = 0; i < s; ++i)
+		a.destroy(slot(gap + i));
+	s = 0;
+	trimBack();
+	shift = min_shift;}
+
+// -----
+// empty
+// -----
+
+bool empty ()const {
+	return !s;}
+
+// ----
+// size
+// ----
+
+size_type size ()const {
+	return s;}};
+
+} // deque
+} // prog
+} // dt
+
+#endif // TieredVector_h
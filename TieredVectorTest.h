@@ -0,0 +1,110 @@
+// -----------------------------
+// prog/deque/TieredVectorTest.h
+// Tj Wrenn
+// -----------------------------
+
+#ifndef TieredVectorTest_h
+#define TieredVectorTest_h
+
+// --------
+// includes
+// --------
+
+#include <cassert>   // assert
+#include <cstdlib>   // rand, srand
+#include <stdexcept> // out_of_range
+#include <vector>    // vector
+
+// ----------
+// namespaces
+// ----------
+
+namespace dt {
+namespace prog  {
+namespace deque  {
+
+// ------------------
+// tiered_vector_test
+// ------------------
+
+/**
+ * function tiered_vector_test is a tester of class TieredVector, instantiated
+ * with an integral element type
+ */
+template <typename TieredVector>
+void tiered_vector_test () {
+	typedef typename TieredVector::value_type value_type;
+	typedef typename TieredVector::size_type  size_type;
+
+	{
+	// ends
+	TieredVector a;
+	assert(a.empty());
+	for(int i = 0; i < 100; ++i){
+		a.push_back(i);
+		a.push_front(-i);}
+	assert(a.size() == 200);
+	assert(a.front() == -99 && a.back() == 99);
+	assert(a[99] == 0 && a[100] == 0);
+	bool thrown = false;
+	try {
+		a.at(200);}
+	catch(std::out_of_range&) {
+		thrown = true;}
+	assert(thrown);
+	for(int i = 0; i < 100; ++i){
+		a.pop_back();
+		a.pop_front();}
+	assert(a.empty());
+	}
+
+	{
+	// inserting one of its own elements, from the side that shifts, in both directions
+	TieredVector a;
+	std::vector<value_type> v;
+	for(int i = 0; i < 1000; ++i){
+		a.push_back(i);
+		v.push_back(i);}
+	size_type at[][2] = {{600, 601}, {600, 603}, {600, 900}, {700, 700}, {300, 299}, {300, 297}, {300, 0}, {500, 2}, {400, 998}};
+	for(int r = 0; r < 9; ++r){
+		a.insert(at[r][0], a[at[r][1]]);
+		value_type x = v[at[r][1]];
+		v.insert(v.begin() + at[r][0], x);
+		assert(a.size() == v.size());
+		for(size_type i = 0; i < v.size(); ++i)
+			assert(a[i] == v[i]);}
+	}
+
+	{
+	// random inserts and erases agree with a vector while the blocks grow and shrink
+	std::srand(17);
+	TieredVector a;
+	std::vector<value_type> v;
+	for(int r = 0; r < 60000; ++r){
+		bool grow = (r < 40000) ? (std::rand() % 4 != 0) : (std::rand() % 4 == 0);
+		if(grow || v.empty()){
+			size_type i = std::rand() % (v.size() + 1);
+			a.insert(i, r);
+			v.insert(v.begin() + i, r);}
+		else{
+			size_type i = std::rand() % v.size();
+			a.erase(i);
+			v.erase(v.begin() + i);}
+		if(r % 997 == 0)
+			for(size_type i = 0; i < v.size(); ++i)
+				assert(a[i] == v[i]);}
+	assert(a.size() == v.size());
+	for(size_type i = 0; i < v.size(); ++i)
+		assert(a[i] == v[i]);
+	a.clear();
+	assert(a.empty());
+	a.push_back(3);
+	assert(a.front() == 3);
+	}
+} // tiered_vector_test
+
+} // deque
+} // prog
+} // dt
+
+#endif // TieredVectorTest_h
@@ -0,0 +1,301 @@
+// -----------------------
+// prog/deque/TimeWindow.h
+// Tj Wrenn
+// -----------------------
+
+#ifndef TimeWindow_h
+#define TimeWindow_h
+
+// --------
+// includes
+// --------
+
+#include <algorithm> // lower_bound
+#include <cassert> // assert
+#include <memory> // allocator
+#include <stdexcept> // invalid_argument
+
+#include "Deque.h"
+
+// ----------
+// namespaces
+// ----------
+
+namespace dt{
+namespace prog{
+namespace deque{
+
+// ----------
+// TimeWindow
+// ----------
+
+/**
+* (timestamp, value) records in time order, with a running sum, count and
+* mean over the records still in the window.
+*
+* expire_before(t) drops every record older than t in one call instead of a
+* loop of front() checks and pop_front()s: it binary searches the first
+* timestamp of each block, then the one block the cutoff falls in, and hands
+* the whole prefix to Deque::erase(first, last), which moves the front
+* marker past it in one step.  The blocks left behind are reused by later
+* pushes.  The sum is updated by subtracting the expired values, read a
+* block at a time.
+*/
+template < typename T, typename Time = long long, typename A = std::allocator<T> >
+class TimeWindow{
+public:
+// --------
+// typedefs
+// --------
+
+typedef A allocator_type;
+typedef typename allocator_type::value_type value_type;
+typedef Time time_type;
+
+typedef typename allocator_type::size_type size_type;
+
+typedef typename allocator_type::const_reference const_reference;
+
+// ------
+// Record
+// ------
+
+struct Record{
+	time_type time;
+	value_type value;
+
+	Record ()
+		: time(), value() {}
+
+	Record (const time_type& time, const_reference value)
+		: time(time), value(value) {}};
+
+typedef Deque<Record, typename A::template rebind<Record>::other> deque_type;
+typedef typename deque_type::const_iterator const_iterator;
+
+private:
+// ----
+// data
+// ----
+
+deque_type d;
+
+/**
+* sum of the values of the records in the window
+*/
+value_type total;
+
+// -----
+// valid
+// -----
+
+/**
+* O(1)
+* M(1)
+* @return true if time window is in valid state
+*/
+bool valid ()const {
+	return d.empty() ? (total == value_type()) : !(d.back().time < d.front().time);}
+
+/**
+* O(1)
+* M(1)
+* @return number of blocks holding records
+*/
+size_type blocks ()const {
+	if(d.empty())
+		return 0;
+	size_type first = d.segment_length(0);
+	return (first == d.size()) ? 1 : 2 + (d.size() - first - 1) / d.segment_length(first);}
+
+/**
+* O(1)
+* M(1)
+* @param k block number, counting the front block as 0
+* @return index of the first record of the k'th block
+*/
+size_type index (size_type k)const {
+	if(k == 0)
+		return 0;
+	size_type first = d.segment_length(0);
+	return (k == 1) ? first : first + (k - 1) * d.segment_length(first);}
+
+static bool earlier (const Record& r, const time_type& t){
+	return r.time < t;}
+
+public:
+// ----------
+// TimeWindow
+// ----------
+
+/**
+* O(1)
+* M(block_size)
+* @param a allocator
+*/
+explicit TimeWindow (const allocator_type& a = allocator_type())
+	: d(a), total() {
+		assert(valid());}
+
+// -----------
+// operator []
+// -----------
+
+/**
+* O(1)
+* M(1)
+* @param index record index
+* @return constant reference to the index'th record
+*/
+const Record& operator [] (size_type index)const {
+	return d[index];}
+
+// -----------
+// front, back
+// -----------
+
+const Record& front ()const {
+	return d.front();}
+
+const Record& back ()const {
+	return d.back();}
+
+// ----------
+// begin, end
+// ----------
+
+const_iterator begin ()const {
+	return d.begin();}
+
+const_iterator end ()const {
+	return d.end();}
+
+// ----
+// push
+// ----
+
+/**
+* appends a record no older than back()
+* ~O(1)
+* M(1)
+* @param t timestamp of the record
+* @param v value of the record
+* @throw std::invalid_argument if t is earlier than back().time
+*/
+void push (const time_type& t, const_reference v){
+	if(!d.empty() && t < d.back().time)
+		throw std::invalid_argument("time window push out of order");
+	d.push_back(Record(t, v));
+	total += v;
+	assert(valid());}
+
+// -----------
+// lower_bound
+// -----------
+
+/**
+* O(log(n / block_size) + log(block_size))
+* M(1)
+* @param t timestamp to search for
+* @return index of the first record not older than t, or size()
+*/
+size_type lower_bound (const time_type& t)const {
+	size_type lo = 0;
+	size_type hi = blocks();
+	while(lo < hi){
+		size_type m = lo + (hi - lo) / 2;
+		if(d[index(m)].time < t)
+			lo = m + 1;
+		else
+			hi = m;}
+	if(lo == 0)
+		return 0;
+	size_type i = index(lo - 1);
+	const Record* p = &d[i];
+	return i + (std::lower_bound(p, p + d.segment_length(i), t, earlier) - p);}
+
+// -------------
+// expire_before
+// -------------
+
+/**
+* drops every record older than t
+* O(log(n) + k) to drop k records, whose values are subtracted from the sum
+* M(1)
+* @param t cutoff timestamp; records at t or later stay
+* @return number of records dropped
+*/
+size_type expire_before (const time_type& t){
+	size_type k = lower_bound(t);
+	if(k == 0)
+		return 0;
+	if(k == d.size())
+		total = value_type();
+	else
+		for(size_type i = 0; i < k; ){
+			size_type n = d.segment_length(i);
+			if(k - i < n)
+				n = k - i;
+			const Record* p = &d[i];
+			for(size_type j = 0; j < n; ++j)
+				total -= p[j].value;
+			i += n;}
+	d.erase(d.begin(), d.begin() + k);
+	assert(valid());
+	return k;}
+
+// -----
+// clear
+// -----
+
+void clear (){
+	d.clear();
+	total = value_type();}
+
+// ----------------
+// sum, count, mean
+// ----------------
+
+/**
+* O(1)
+* M(1)
+* @return sum of the values in the window
+*/
+const_reference sum ()const {
+	return total;}
+
+/**
+* O(1)
+* M(1)
+* @return number of records in the window
+*/
+size_type count ()const {
+	return d.size();}
+
+/**
+* O(1)
+* M(1)
+* @return mean of the values in the window, or 0 if it is empty
+*/
+double mean ()const {
+	return d.empty() ? 0.0 : (double)total / d.size();}
+
+// -----
+// empty
+// -----
+
+bool empty ()const {
+	return d.empty();}
+
+// ----
+// size
+// ----
+
+size_type size ()const {
+	return d.size();}};
+
+} // deque
+} // prog
+} // dt
+
+#endif // TimeWindow_h
@@ -0,0 +1,111 @@
+// ---------------------------
+// prog/deque/TimeWindowTest.h
+// Tj Wrenn
+// ---------------------------
+
+#ifndef TimeWindowTest_h
+#define TimeWindowTest_h
+
+// --------
+// includes
+// --------
+
+#include <cassert>   // assert
+#include <cstdlib>   // rand, srand
+#include <stdexcept> // invalid_argument
+#include <vector>    // vector
+
+// ----------
+// namespaces
+// ----------
+
+namespace dt {
+namespace prog  {
+namespace deque  {
+
+// ----------------
+// time_window_test
+// ----------------
+
+/**
+ * function time_window_test is a tester of class TimeWindow, instantiated
+ * with integral value and time types
+ */
+template <typename TimeWindow>
+void time_window_test () {
+	typedef typename TimeWindow::value_type value_type;
+	typedef typename TimeWindow::time_type  time_type;
+	typedef typename TimeWindow::size_type  size_type;
+
+	{
+	// empty
+	TimeWindow a;
+	assert(a.empty() && a.count() == 0 && a.sum() == 0 && a.mean() == 0.0);
+	assert(a.expire_before(10) == 0);
+	assert(a.lower_bound(10) == 0);
+	}
+
+	{
+	// push keeps time order
+	TimeWindow a;
+	a.push(5, 1);
+	a.push(5, 2);
+	a.push(8, 3);
+	bool thrown = false;
+	try {
+		a.push(7, 4);}
+	catch(std::invalid_argument&) {
+		thrown = true;}
+	assert(thrown);
+	assert(a.count() == 3 && a.sum() == 6 && a.mean() == 2.0);
+	assert(a.lower_bound(5) == 0 && a.lower_bound(6) == 2 && a.lower_bound(9) == 3);
+	assert(a.expire_before(5) == 0);
+	assert(a.expire_before(6) == 2);
+	assert(a.front().time == 8 && a.sum() == 3);
+	assert(a.expire_before(100) == 1);
+	assert(a.empty() && a.sum() == 0);
+	}
+
+	{
+	// a sliding window over many blocks agrees with a scan
+	std::srand(13);
+	TimeWindow a;
+	std::vector<time_type>  ts;
+	std::vector<value_type> vs;
+	size_type first = 0;
+	time_type t = 0;
+	for(int r = 0; r < 20000; ++r){
+		if(std::rand() % 50){
+			t += std::rand() % 3;
+			value_type v = std::rand() % 100 - 50;
+			a.push(t, v);
+			ts.push_back(t);
+			vs.push_back(v);}
+		else{
+			time_type cut = t - std::rand() % 2000;
+			size_type k = first;
+			while(k < ts.size() && ts[k] < cut)
+				++k;
+			assert(a.lower_bound(cut) == k - first);
+			assert(a.expire_before(cut) == k - first);
+			first = k;}
+		value_type sum = 0;
+		if(r % 97 == 0){
+			for(size_type i = first; i < vs.size(); ++i)
+				sum += vs[i];
+			assert(a.sum() == sum);}
+		assert(a.count() == ts.size() - first);}
+	for(size_type i = 0; i < a.size(); ++i)
+		assert(a[i].time == ts[first + i] && a[i].value == vs[first + i]);
+	a.clear();
+	assert(a.empty() && a.sum() == 0);
+	a.push(0, 7);
+	assert(a.sum() == 7);
+	}
+} // time_window_test
+
+} // deque
+} // prog
+} // dt
+
+#endif // TimeWindowTest_h
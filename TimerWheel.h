@@ -0,0 +1,358 @@
+// -----------------------
+// prog/deque/TimerWheel.h
+// Tj Wrenn
+// -----------------------
+
+#ifndef TimerWheel_h
+#define TimerWheel_h
+
+// --------
+// includes
+// --------
+
+#include <cassert> // assert
+#include <cstdint> // uint32_t, uint64_t
+#include <utility> // move
+#include <vector> // vector
+
+#include "BlockCache.h"
+#include "Deque.h"
+
+// ----------
+// namespaces
+// ----------
+
+namespace dt{
+namespace prog{
+namespace deque{
+
+// ----------
+// TimerWheel
+// ----------
+
+/**
+* A hierarchical timing wheel: levels of slots, each slot a Deque of timers,
+* level k's slots spanning slots^k ticks each.  schedule() pushes a timer
+* onto the slot of the coarsest level that still tells it apart from now,
+* and advance() walks the ticks; when a tick crosses a slot boundary of a
+* higher level, that slot is cascaded, its timers pushed down to finer slots.
+*
+* cancel() leaves a tombstone: every timer id carries the generation of its
+* entry in a table, and cancelling or firing bumps the generation, so the
+* timer is skipped wherever it lies when its slot is next cascaded or fired.
+*
+* Firing is a batch per tick: the tick's slot is appended to the caller's
+* Deque, by pointer swap if that Deque is empty and block by block if it is
+* aligned, and only then walked once to drop tombstones.  Every slot
+* allocates through one BlockCache, so a slot that is emptied gives its
+* blocks back to the cache and the next slot to fill takes them from there.
+* Each slot holds one block even when empty.
+*/
+template <typename T>
+class TimerWheel{
+public:
+// --------
+// typedefs
+// --------
+
+typedef T value_type;
+typedef std::size_t size_type;
+
+typedef std::uint64_t tick_type;
+typedef std::uint64_t timer_id;
+
+// -----
+// Timer
+// -----
+
+struct Timer{
+	tick_type when;
+	timer_id id;
+	value_type value;
+
+	Timer ()
+		: when(), id(), value() {}
+
+	Timer (tick_type when, timer_id id, const value_type& value)
+		: when(when), id(id), value(value) {}};
+
+typedef CachedAllocator<Timer> allocator_type;
+typedef Deque<Timer, allocator_type> deque_type;
+
+// -------------
+// static consts
+// -------------
+
+static const size_type levels = 4;
+
+/**
+* log2 of the number of slots per level
+*/
+static const size_type bits = 8;
+static const size_type slots = (size_type)1 << bits;
+
+private:
+// ----
+// data
+// ----
+
+/**
+* declared first so that it outlives the slots
+*/
+BlockCache cache;
+
+/**
+* the slots of level k are wheel[k * slots, (k + 1) * slots); overflow holds
+* timers past the last level, looked at again each time the last level wraps
+*/
+std::vector<deque_type> wheel;
+deque_type overflow;
+
+/**
+* the last tick advanced to
+*/
+tick_type t;
+
+/**
+* gens[i] is the generation of a live timer with entry i, or was before it fired
+* or was cancelled; unused lists the entries not in use
+*/
+std::vector<std::uint32_t> gens;
+std::vector<std::uint32_t> unused;
+
+size_type s;
+
+// -------
+// copying
+// -------
+
+TimerWheel (const TimerWheel&);
+TimerWheel& operator = (const TimerWheel&);
+
+// -----
+// valid
+// -----
+
+/**
+* O(1)
+* M(1)
+* @return true if timer wheel is in valid state
+*/
+bool valid ()const {
+	return (wheel.size() == levels * slots) && (s + unused.size() == gens.size());}
+
+/**
+* O(1)
+* M(1)
+* @param x a timer
+* @return true if x has been neither cancelled nor fired
+*/
+bool live (const Timer& x)const {
+	return gens[(std::uint32_t)x.id] == (std::uint32_t)(x.id >> 32);}
+
+/**
+* ends a timer's life, so any copy of it left in a slot is a tombstone
+* O(1)
+* M(1)
+* @param id a live timer's id
+*/
+void retire (timer_id id){
+	std::uint32_t i = (std::uint32_t)id;
+	++gens[i];
+	unused.push_back(i);
+	--s;}
+
+/**
+* pushes x onto the slot of the coarsest level whose slot boundaries still
+* separate x's tick from the current one, or onto overflow
+* O(1)
+* M(1)
+* @param x a live timer
+* @param earliest tick to fire x at if it is due sooner: the next tick for a new
+* timer, the current one for a timer being cascaded, whose slot has yet to fire
+*/
+void place (Timer&& x, tick_type earliest){
+	tick_type w = (x.when > earliest) ? x.when : earliest;
+	for(size_type k = 0; k < levels; ++k)
+		if((w >> (bits * (k + 1))) == (t >> (bits * (k + 1)))){
+			wheel[k * slots + ((w >> (bits * k)) & (slots - 1))].push_back(std::move(x));
+			return;}
+	overflow.push_back(std::move(x));}
+
+/**
+* pushes the live timers of a slot down to finer slots, then gives the slot's
+* blocks back to the cache
+* O(n + n / block_size), where n is the number of timers in the slot
+* M(1)
+* @param q a slot
+*/
+void cascade (deque_type& q){
+	if(q.empty())
+		return;
+	allocator_type x(&cache);
+	deque_type r(x);
+	r.swap(q);
+	for(size_type i = 0; i < r.size(); ){
+		size_type n = r.segment_length(i);
+		Timer* p = &r[i];
+		for(size_type j = 0; j < n; ++j)
+			if(live(p[j]))
+				place(std::move(p[j]), t);
+		i += n;}}
+
+/**
+* moves to the next tick: cascades the higher level slots whose boundary it
+* crosses, coarsest first, then fires its level 0 slot into out
+* O(1 + n), where n is the number of timers cascaded or fired
+* M(1)
+* @param out where the fired timers are appended
+* @return number of timers fired
+*/
+size_type tick (deque_type& out){
+	++t;
+	if((t & ((((tick_type)1) << (bits * levels)) - 1)) == 0)
+		cascade(overflow);
+	for(size_type k = levels - 1; k > 0; --k)
+		if((t & ((((tick_type)1) << (bits * k)) - 1)) == 0)
+			cascade(wheel[k * slots + ((t >> (bits * k)) & (slots - 1))]);
+	deque_type& q = wheel[t & (slots - 1)];
+	if(q.empty())
+		return 0;
+	size_type from = out.size();
+	out.append(std::move(q));
+	deque_type(allocator_type(&cache)).swap(q);
+	size_type to = from;
+	for(size_type i = from; i < out.size(); ++i){
+		Timer& x = out[i];
+		if(!live(x))
+			continue;
+		retire(x.id);
+		if(i != to)
+			out[to] = std::move(x);
+		++to;}
+	out.erase(out.begin() + to, out.end());
+	return to - from;}
+
+public:
+// ----------
+// TimerWheel
+// ----------
+
+/**
+* O(levels * slots)
+* M(levels * slots * block_size)
+* @param now the tick to start at
+*/
+explicit TimerWheel (tick_type now = 0)
+	: overflow(allocator_type(&cache)), t(now), s(0) {
+		wheel.reserve(levels * slots);
+		for(size_type i = 0; i < levels * slots; ++i)
+			wheel.push_back(deque_type(allocator_type(&cache)));
+		assert(valid());}
+
+// ---------
+// allocator
+// ---------
+
+/**
+* O(1)
+* M(1)
+* @return an allocator drawing from the wheel's block cache, for the Deques handed to advance()
+*/
+allocator_type allocator (){
+	return allocator_type(&cache);}
+
+// --------
+// schedule
+// --------
+
+/**
+* O(1)
+* M(1)
+* @param when tick to fire at; a tick not after now() fires at the next one
+* @param v value to hand back when the timer fires
+* @return id of the timer, for cancel()
+*/
+timer_id schedule (tick_type when, const value_type& v){
+	std::uint32_t i;
+	if(unused.empty()){
+		i = (std::uint32_t)gens.size();
+		gens.push_back(0);}
+	else{
+		i = unused.back();
+		unused.pop_back();}
+	timer_id id = ((timer_id)gens[i] << 32) | i;
+	place(Timer(when, id, v), t + 1);
+	++s;
+	assert(valid());
+	return id;}
+
+// ------
+// cancel
+// ------
+
+/**
+* O(1)
+* M(1)
+* @param id a timer's id
+* @return true if the timer was pending, false if it had already fired or been cancelled
+*/
+bool cancel (timer_id id){
+	std::uint32_t i = (std::uint32_t)id;
+	if(i >= gens.size() || gens[i] != (std::uint32_t)(id >> 32))
+		return false;
+	retire(id);
+	assert(valid());
+	return true;}
+
+// -------
+// advance
+// -------
+
+/**
+* fires every timer due up to and including tick to, in tick order
+* O(d + n), where d is the number of ticks and n the number of timers cascaded or fired
+* M(1)
+* @param to tick to advance to
+* @param out where the fired timers are appended; it may take over blocks, and the
+* allocator, of the wheel's slots, so it must not outlive the wheel
+* @return number of timers fired
+*/
+size_type advance (tick_type to, deque_type& out){
+	size_type n = 0;
+	while(t < to)
+		n += tick(out);
+	assert(valid());
+	return n;}
+
+// ---
+// now
+// ---
+
+tick_type now ()const {
+	return t;}
+
+// -----
+// empty
+// -----
+
+bool empty ()const {
+	return !s;}
+
+// ----
+// size
+// ----
+
+/**
+* O(1)
+* M(1)
+* @return number of pending timers
+*/
+size_type size ()const {
+	return s;}};
+
+} // deque
+} // prog
+} // dt
+
+#endif // TimerWheel_h
@@ -0,0 +1,120 @@
+// ---------------------------
+// prog/deque/TimerWheelTest.h
+// Tj Wrenn
+// ---------------------------
+
+#ifndef TimerWheelTest_h
+#define TimerWheelTest_h
+
+// --------
+// includes
+// --------
+
+#include <cassert> // assert
+#include <cstdlib> // rand, srand
+#include <vector>  // vector
+
+// ----------
+// namespaces
+// ----------
+
+namespace dt {
+namespace prog  {
+namespace deque  {
+
+// ----------------
+// timer_wheel_test
+// ----------------
+
+/**
+ * function timer_wheel_test is a tester of class TimerWheel, instantiated
+ * with an integral value type
+ */
+template <typename TimerWheel>
+void timer_wheel_test () {
+	typedef typename TimerWheel::size_type  size_type;
+	typedef typename TimerWheel::tick_type  tick_type;
+	typedef typename TimerWheel::timer_id   timer_id;
+	typedef typename TimerWheel::deque_type deque_type;
+
+	{
+	// schedule, cancel and fire
+	TimerWheel w;
+	deque_type out(w.allocator());
+	timer_id a = w.schedule(3, 30);
+	timer_id b = w.schedule(3, 31);
+	timer_id c = w.schedule(1000, 32);
+	w.schedule(0, 33);
+	assert(w.size() == 4);
+	assert(w.cancel(b));
+	assert(!w.cancel(b));
+	assert(w.size() == 3);
+	assert(w.advance(1, out) == 1 && out.back().value == 33);
+	assert(w.advance(2, out) == 0);
+	assert(w.advance(3, out) == 1 && out.back().value == 30 && out.back().id == a);
+	assert(!w.cancel(a));
+	assert(w.advance(999, out) == 0);
+	assert(w.advance(1000, out) == 1 && out.back().id == c);
+	assert(w.empty() && out.size() == 3 && w.now() == 1000);
+	}
+
+	{
+	// timers past the last level wait in overflow until it wraps
+	const tick_type wrap = (tick_type)1 << (TimerWheel::bits * TimerWheel::levels);
+	TimerWheel w(wrap - 100);
+	deque_type out(w.allocator());
+	w.schedule(wrap + 50, 1);
+	w.schedule(wrap - 1, 2);
+	assert(w.advance(wrap - 1, out) == 1 && out.back().value == 2);
+	assert(w.advance(wrap + 49, out) == 0);
+	assert(w.advance(wrap + 50, out) == 1 && out.back().value == 1);
+	}
+
+	{
+	// random timers fire at their tick, once, unless cancelled
+	std::srand(17);
+	TimerWheel w(12345);
+	std::vector<tick_type> due;
+	std::vector<timer_id>  ids;
+	std::vector<int>       state; // 0 pending, 1 fired, 2 cancelled
+	size_type pending = 0;
+	for(int r = 0; r < 200; ++r){
+		for(int i = std::rand() % 200; i > 0; --i){
+			tick_type d = w.now() + ((std::rand() % 4) ? std::rand() % 300 : std::rand() % 200000);
+			ids.push_back(w.schedule(d, (int)due.size()));
+			due.push_back(d > w.now() ? d : w.now() + 1);
+			state.push_back(0);
+			++pending;}
+		for(int i = std::rand() % 30; i > 0 && !ids.empty(); --i){
+			size_type k = std::rand() % ids.size();
+			assert(w.cancel(ids[k]) == (state[k] == 0));
+			if(state[k] == 0){
+				state[k] = 2;
+				--pending;}}
+		tick_type to = w.now() + std::rand() % 2000;
+		while(w.now() < to){
+			deque_type out(w.allocator());
+			size_type n = w.advance(w.now() + 1, out);
+			assert(n == out.size());
+			for(size_type i = 0; i < out.size(); ++i){
+				int k = out[i].value;
+				assert(state[k] == 0 && due[k] == w.now() && ids[k] == out[i].id);
+				state[k] = 1;
+				--pending;}}
+		assert(w.size() == pending);}
+	deque_type out(w.allocator());
+	assert(w.advance(w.now() + 300000, out) == pending);
+	assert(w.empty());
+	for(size_type i = 0; i < out.size(); ++i){
+		assert(state[out[i].value] == 0);
+		state[out[i].value] = 1;}
+	for(size_type k = 0; k < state.size(); ++k)
+		assert(state[k] != 0);
+	}
+} // timer_wheel_test
+
+} // deque
+} // prog
+} // dt
+
+#endif // TimerWheelTest_h
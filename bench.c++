@@ -0,0 +1,51 @@
+// --------------------
+// prog/deque/bench.c++
+// --------------------
+
+// --------
+// includes
+// --------
+
+#include <iostream> // cout, endl
+
+#include "Deque.h"
+#include "DequeBench.h"
+#include "SortedDeque.h"
+
+// ----
+// main
+// ----
+
+/**
+ * function main is a driver of the deque benchmarks; build it with optimizations
+ * and without assertions, e.g. g++ -std=c++11 -O2 -DNDEBUG -pthread bench.c++
+ */
+int main () {
+    using namespace std;
+    using namespace dt::prog::deque;
+    algorithm_bench< Deque<int> >("Deque<int>");
+    algorithm_bench< Deque<double> >("Deque<double>");
+    comparison_bench< Deque<int> >("Deque<int>");
+    comparison_bench< Deque<double> >("Deque<double>");
+    parallel_bench< Deque<int> >("Deque<int>");
+    parallel_bench< Deque<double> >("Deque<double>");
+    sort_bench< Deque<int> >("Deque<int>");
+    sort_bench< Deque<double> >("Deque<double>");
+    sorted_bench< SortedDeque<int> >("SortedDeque<int>");
+    tiered_bench<int>("n = 100000", 100000, 1);
+    tiered_bench<int>("n = 100000", 100000, 16);
+    tiered_bench<int>("n = 1000000", 1000000, 1);
+    gap_bench("n = 1000000", 1000000);
+    window_bench("w = 16", 16);
+    window_bench("w = 4096", 4096);
+    time_window_bench("batch = 64", 64);
+    time_window_bench("batch = 4096", 4096);
+    timer_bench("n = 100000", 100000);
+    timer_bench("n = 1000000", 1000000);
+    latency_bench< Deque<int> >("Deque<int>", 1 << 22);
+    latency_bench< std::deque<int> >("std::deque<int>", 1 << 22);
+    latency_bench< std::vector<int> >("std::vector<int>", 1 << 22);
+    slab_bench("n = 1000000", 1000000);
+    drain_bench("n = 1000000", 1000000);
+    cout << "Done." << endl;
+    return 0;}
@@ -8,19 +8,76 @@
 
 #include <iostream> // cout, endl
 
+#include "AppendLog.h"
+#include "AppendLogTest.h"
+#include "CowDeque.h"
+#include "CowDequeTest.h"
 #include "Deque.h"
 #include "DequeTest.h"
+#include "DequeObserver.h"
+#include "DequeObserverTest.h"
+#include "DequeStats.h"
+#include "DequeStatsTest.h"
+#include "DequeAlgorithm.h"
+#include "DequeAlgorithmTest.h"
+#include "DequeParallel.h"
+#include "DequeParallelTest.h"
+#include "DequeSort.h"
+#include "DequeSortTest.h"
+#include "GapDeque.h"
+#include "GapDequeTest.h"
+#include "HugePageAllocator.h"
+#include "HugePageAllocatorTest.h"
+#include "SequencedDeque.h"
+#include "SequencedDequeTest.h"
+#include "SlabAllocator.h"
+#include "SlabAllocatorTest.h"
+#include "SlidingWindowExtrema.h"
+#include "SlidingWindowExtremaTest.h"
+#include "SortedDeque.h"
+#include "SortedDequeTest.h"
+#include "TieredVector.h"
+#include "TimeWindow.h"
+#include "TimeWindowTest.h"
+#include "TimerWheel.h"
+#include "TimerWheelTest.h"
+#include "TieredVectorTest.h"
 
 // ----
 // main
 // ----
 
 /**
- * function main is a driver of function deque_test instantiated with class Deque
+ * function main is a driver of the deque testers instantiated with their classes
  */
 int main () {
     using namespace std;
     using namespace dt::prog::deque;
     deque_test< Deque<int> >();
+    deque_test< Deque<int, std::allocator<int>, DequeStats> >();
+    deque_stats_test< Deque<int, std::allocator<int>, DequeStats> >();
+    deque_observer_test< Deque<int, std::allocator<int>, NoStats, RingTracer<64, 8> > >();
+    deque_algorithm_test< Deque<int> >();
+    deque_algorithm_test< Deque<double> >();
+    deque_algorithm_test< Deque<long> >();
+    deque_algorithm_test< Deque<int, std::allocator<int>, DequeStats> >();
+    deque_parallel_test< Deque<int> >();
+    deque_parallel_test< Deque<int, std::allocator<int>, DequeStats, RingTracer<> > >();
+    deque_sort_test< Deque<int> >();
+    deque_sort_test< Deque<double> >();
+    deque_sort_test< Deque<short> >();
+    deque_sort_test< Deque<double, std::allocator<double>, NoStats, RingTracer<> > >();
+    deque_stable_sort_test< Deque< std::pair<int, int> > >();
+    cow_deque_test< CowDeque<int> >();
+    append_log_test< AppendLog<int> >();
+    gap_deque_test< GapDeque<int> >();
+    huge_page_allocator_test< Deque<int, HugePageAllocator<int> > >();
+    sequenced_deque_test< SequencedDeque<int> >();
+    slab_allocator_test< Deque<int, SlabAllocator<int> > >();
+    sliding_window_extrema_test< SlidingWindowExtrema<int> >();
+    sorted_deque_test< SortedDeque<int> >();
+    tiered_vector_test< TieredVector<int> >();
+    time_window_test< TimeWindow<long> >();
+    timer_wheel_test< TimerWheel<int> >();
     cout << "Done." << endl;
     return 0;}
@@ -0,0 +1,32 @@
+// -------------------
+// prog/deque/perf.c++
+// -------------------
+
+// --------
+// includes
+// --------
+
+#include <iostream> // cout, endl
+
+#include "DequePerf.h"
+
+// ----
+// main
+// ----
+
+/**
+ * function main is a driver of the hardware counter measurements in
+ * DequePerf.h; build it like bench.c++, e.g.
+ * g++ -std=c++11 -O2 -DNDEBUG -pthread perf.c++
+ * counters the kernel will not open read n/a; on Linux, lowering
+ * /proc/sys/kernel/perf_event_paranoid to 2 or less lets a user count its own threads
+ */
+int main () {
+    using namespace std;
+    using namespace dt::prog::deque;
+    PerfCounters counters;
+    perf_bench< Deque<int> >(counters, "Deque<int>", 1 << 22);
+    perf_bench< Deque<double> >(counters, "Deque<double>", 1 << 22);
+    hugepage_bench(counters, 1 << 24);
+    cout << "Done." << endl;
+    return 0;}
@@ -0,0 +1,30 @@
+// --------------------
+// prog/deque/suite.c++
+// --------------------
+
+// --------
+// includes
+// --------
+
+#include <iostream> // cout, endl
+
+#include "DequeSuite.h"
+
+// ----
+// main
+// ----
+
+/**
+ * function main is a driver of the container comparison in DequeSuite.h;
+ * build it with optimizations and without assertions, e.g.
+ * g++ -std=c++11 -O2 -DNDEBUG -pthread suite.c++
+ */
+int main () {
+    using namespace std;
+    using namespace dt::prog::deque;
+    suite_sizes<4>("4B");
+    suite_sizes<16>("16B");
+    suite_sizes<64>("64B");
+    suite_sizes<256>("256B");
+    cout << "Done." << endl;
+    return 0;}